@@ -0,0 +1,1238 @@
+/**
+  ******************************************************************************
+  * @file    iis3dwb_dsp.c
+  * @author  Sensors Software Solution Team
+  * @brief   IIS3DWB optional signal processing
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "iis3dwb_dsp.h"
+#include <string.h>
+
+/**
+  * @defgroup    IIS3DWB_DSP IIS3DWB Signal Processing
+  * @brief       This file provides optional processing of the decoded
+  *              iis3dwb sample stream. Unlike iis3dwb_reg.c it needs the
+  *              math library (-lm); link it only when these functions
+  *              are used.
+  * @{
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_goertzel Goertzel Filter Bank
+  * @brief      This section groups the functions that track the amplitude
+  *             and phase of a set of frequencies (running speed harmonics,
+  *             blade pass, bearing defect frequencies) over blocks of the
+  *             decoded sample stream, at a fraction of the cost of a
+  *             full FFT.
+  *             Bins are stored as arrays and updated in the inner loop,
+  *             so the compiler can vectorize the bank on SIMD targets.
+  * @{
+  *
+  */
+
+#define GOERTZEL_2PI          6.28318530718f
+
+/**
+  * @brief  Initialize a Goertzel filter bank.
+  *
+  * @param  g          Filter bank.(ptr)
+  * @param  freq_hz    Frequencies (Hz), any value below odr_hz / 2,
+  *                    not restricted to the FFT bin grid.(ptr)
+  * @param  num        Number of frequencies (1 .. IIS3DWB_GOERTZEL_BINS).
+  * @param  odr_hz     Sample rate, e.g. from iis3dwb_xl_odr_actual_get.
+  * @param  block_len  Samples per block; the resolution is
+  *                    odr_hz / block_len.
+  * @retval            0 -> bank ready, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_goertzel_init(iis3dwb_goertzel_t *g, const float_t *freq_hz,
+                              uint8_t num, float_t odr_hz,
+                              uint32_t block_len)
+{
+  float_t w;
+  float_t turns;
+  uint8_t i;
+
+  if ((num == 0U) || (num > IIS3DWB_GOERTZEL_BINS) || (block_len == 0U) ||
+      (odr_hz <= 0.0f))
+  {
+    return -1;
+  }
+
+  memset(g, 0, sizeof(iis3dwb_goertzel_t));
+
+  for (i = 0U; i < num; i++)
+  {
+    if ((freq_hz[i] < 0.0f) || ((2.0f * freq_hz[i]) >= odr_hz))
+    {
+      return -1;
+    }
+
+    w = GOERTZEL_2PI * freq_hz[i] / odr_hz;
+    g->cos_w[i] = cosf(w);
+    g->sin_w[i] = sinf(w);
+    g->coeff[i] = 2.0f * g->cos_w[i];
+
+    /* w (block_len - 1), reduced in turns to keep the precision */
+    turns = (freq_hz[i] / odr_hz) * (float_t)(block_len - 1U);
+    g->w_end[i] = GOERTZEL_2PI * (turns - floorf(turns));
+  }
+
+  g->num = num;
+  g->block_len = block_len;
+
+  return 0;
+}
+
+/**
+  * @brief  Run the filter bank over decoded samples. When a block is
+  *         complete its amplitude and phase are written to out and
+  *         a new block starts.
+  *
+  * @param  g       Filter bank.(ptr)
+  * @param  x       Samples, e.g. one axis of iis3dwb_fifo_dec_run
+  *                 output.(ptr)
+  * @param  num     Samples available / consumed: less than available
+  *                 when a block was completed, call again with the
+  *                 rest.(ptr)
+  * @param  stride  Distance between samples in x (3 for one axis of
+  *                 X, Y, Z samples).
+  * @param  out     Amplitude and phase of each bin.(ptr)
+  * @retval         1 -> block completed and out updated, 0 -> otherwise.
+  *
+  */
+uint8_t iis3dwb_goertzel_run(iis3dwb_goertzel_t *g, const int16_t *x,
+                             uint32_t *num, uint8_t stride,
+                             iis3dwb_goertzel_out_t *out)
+{
+  const float_t norm = 2.0f / (float_t)g->block_len;
+  float_t s0;
+  float_t re;
+  float_t im;
+  float_t ph;
+  float_t v;
+  uint32_t n;
+  uint8_t done = 0U;
+  uint8_t i;
+
+  for (n = 0U; (n < *num) && (g->cnt < g->block_len); n++)
+  {
+    v = (float_t)x[n * stride];
+
+    for (i = 0U; i < g->num; i++)
+    {
+      s0 = v + (g->coeff[i] * g->s1[i]) - g->s2[i];
+      g->s2[i] = g->s1[i];
+      g->s1[i] = s0;
+    }
+
+    g->cnt++;
+  }
+
+  if (g->cnt == g->block_len)
+  {
+    for (i = 0U; i < g->num; i++)
+    {
+      /* DFT at w = e^-jw(N-1) (s1 - e^-jw s2) */
+      re = g->s1[i] - (g->s2[i] * g->cos_w[i]);
+      im = g->s2[i] * g->sin_w[i];
+      out[i].amp = norm * sqrtf((re * re) + (im * im));
+
+      ph = atan2f(im, re) - g->w_end[i];
+      ph = (ph < -3.14159265359f) ? (ph + GOERTZEL_2PI) : ph;
+      out[i].phase = ph;
+
+      g->s1[i] = 0.0f;
+      g->s2[i] = 0.0f;
+    }
+
+    g->cnt = 0U;
+    done = 1U;
+  }
+
+  *num = n;
+
+  return done;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_kurtogram Fast Kurtogram
+  * @brief      This section groups the functions that select the most
+  *             impulsive frequency band of a block of samples (fast
+  *             kurtogram, 1/3-binary filter tree) and extract the
+  *             squared envelope of that band for envelope analysis.
+  *             Each level splits every band in two (or three) with
+  *             complex quasi-analytic FIR filters and decimates, so the
+  *             whole tree costs a few FIR passes over the block.
+  * @{
+  *
+  */
+
+#define KURT_TAPS2            16U
+#define KURT_TAPS3            24U
+#define KURT_MIN_LEN          64U
+#define KURT_PI               3.14159265359f
+
+typedef struct
+{
+  float_t h2[2][2U * KURT_TAPS2];   /* halves: re, im interleaved */
+  float_t h3[3][2U * KURT_TAPS3];   /* thirds: re, im interleaved */
+} kurt_bank_t;
+
+/* Hann windowed low pass of cutoff wc, shifted to the band center w0 */
+static void kurt_taps(float_t *h, uint8_t taps, float_t wc, float_t w0)
+{
+  const float_t c = 0.5f * (float_t)(taps - 1U);
+  float_t t;
+  float_t v;
+  uint8_t n;
+
+  for (n = 0U; n < taps; n++)
+  {
+    t = (float_t)n - c;
+    v = sinf(wc * t) / (KURT_PI * t);
+    v *= 0.5f - (0.5f * cosf((2.0f * KURT_PI * ((float_t)n + 1.0f)) /
+                             ((float_t)taps + 1.0f)));
+    h[2U * n] = v * cosf(w0 * (float_t)n);
+    h[(2U * n) + 1U] = v * sinf(w0 * (float_t)n);
+  }
+}
+
+static void kurt_bank_init(kurt_bank_t *bank)
+{
+  uint8_t i;
+
+  for (i = 0U; i < 2U; i++)
+  {
+    kurt_taps(bank->h2[i], KURT_TAPS2, 0.25f * KURT_PI,
+              ((2.0f * (float_t)i) + 1.0f) * 0.25f * KURT_PI);
+  }
+
+  for (i = 0U; i < 3U; i++)
+  {
+    kurt_taps(bank->h3[i], KURT_TAPS3, KURT_PI / 6.0f,
+              ((2.0f * (float_t)i) + 1.0f) * KURT_PI / 6.0f);
+  }
+}
+
+/* Filter and decimate a complex band: [k/dec, (k+1)/dec) of the input
+ * band becomes the whole output band, odd sub-bands are shifted by pi
+ * to keep the frequency order.
+ */
+static uint32_t kurt_split(const float_t *in, uint32_t len, const float_t *h,
+                           uint8_t taps, uint8_t dec, uint8_t flip,
+                           float_t *out)
+{
+  const uint32_t out_len = (len < taps) ? 0U : ((len - taps) / dec) + 1U;
+  const float_t *p;
+  float_t re;
+  float_t im;
+  uint32_t m;
+  uint8_t k;
+
+  for (m = 0U; m < out_len; m++)
+  {
+    /* newest sample first: p[-k] is multiplied by h[k] */
+    p = &in[2U * ((dec * m) + taps - 1U)];
+    re = 0.0f;
+    im = 0.0f;
+
+    for (k = 0U; k < taps; k++)
+    {
+      re += (h[2U * k] * p[0]) - (h[(2U * k) + 1U] * p[1]);
+      im += (h[2U * k] * p[1]) + (h[(2U * k) + 1U] * p[0]);
+      p = &p[-2];
+    }
+
+    if ((flip != 0U) && ((m & 1U) != 0U))
+    {
+      re = -re;
+      im = -im;
+    }
+    out[2U * m] = re;
+    out[(2U * m) + 1U] = im;
+  }
+
+  return out_len;
+}
+
+/* E|c|^4 / (E|c|^2)^2 - offset: 2 for complex, 3 for real signals */
+static float_t kurt_value(const float_t *c, uint32_t len, float_t offset)
+{
+  float_t m2 = 0.0f;
+  float_t m4 = 0.0f;
+  float_t e;
+  uint32_t m;
+
+  for (m = 0U; m < len; m++)
+  {
+    e = (c[2U * m] * c[2U * m]) + (c[(2U * m) + 1U] * c[(2U * m) + 1U]);
+    m2 += e;
+    m4 += e * e;
+  }
+
+  return (m2 > 0.0f) ? (((m4 * (float_t)len) / (m2 * m2)) - offset) : 0.0f;
+}
+
+static void kurt_keep(iis3dwb_kurt_band_t *best, float_t kurt, uint8_t level,
+                      uint8_t third, uint16_t band, float_t odr_hz)
+{
+  const float_t div = (third != 0U) ? 3.0f : 1.0f;
+
+  if (kurt > best->kurt)
+  {
+    best->kurt = kurt;
+    best->level = level;
+    best->third = third;
+    best->band = band;
+    best->bw_hz = (0.5f * odr_hz) / (div * (float_t)(1UL << level));
+    best->fc_hz = ((float_t)band + 0.5f) * best->bw_hz;
+  }
+}
+
+static void kurt_load(const int16_t *x, uint32_t num, uint8_t stride,
+                      float_t *c)
+{
+  uint32_t n;
+
+  for (n = 0U; n < num; n++)
+  {
+    c[2U * n] = (float_t)x[n * stride];
+    c[(2U * n) + 1U] = 0.0f;
+  }
+}
+
+/**
+  * @brief  Compute the fast kurtogram of a block and return its most
+  *         impulsive band.
+  *
+  * @param  x       Samples, e.g. one axis of iis3dwb_fifo_dec_run
+  *                 output.(ptr)
+  * @param  num     Number of samples.
+  * @param  stride  Distance between samples in x (3 for one axis of
+  *                 X, Y, Z samples).
+  * @param  levels  Binary levels (1 .. IIS3DWB_KURT_LEVELS_MAX), fewer
+  *                 when the decimated bands get too short.
+  * @param  odr_hz  Sample rate, e.g. from iis3dwb_xl_odr_actual_get.
+  * @param  work    IIS3DWB_KURT_WORK_LEN(num) elements.(ptr)
+  * @param  best    Band of the highest spectral kurtosis.(ptr)
+  * @retval         0 -> best band found, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_kurtogram_run(const int16_t *x, uint32_t num,
+                              uint8_t stride, uint8_t levels, float_t odr_hz,
+                              float_t *work, iis3dwb_kurt_band_t *best)
+{
+  kurt_bank_t bank;
+  float_t *cur = work;
+  float_t *next = &work[2U * num];
+  float_t *tmp;
+  uint32_t len = num;
+  uint32_t sub = 0U;
+  uint16_t bands = 1U;
+  uint16_t b;
+  uint8_t lvl;
+  uint8_t t;
+
+  if ((num < KURT_MIN_LEN) || (levels == 0U) ||
+      (levels > IIS3DWB_KURT_LEVELS_MAX))
+  {
+    return -1;
+  }
+
+  kurt_bank_init(&bank);
+  kurt_load(x, num, stride, cur);
+
+  memset(best, 0, sizeof(iis3dwb_kurt_band_t));
+  best->kurt = -3.0f;
+  kurt_keep(best, kurt_value(cur, len, 3.0f), 0U, 0U, 0U, odr_hz);
+
+  for (lvl = 0U; (lvl < levels) && (((len - KURT_TAPS3) / 3U) >= KURT_MIN_LEN);
+       lvl++)
+  {
+    /* thirds of this level, next is scratch until the halves below */
+    for (b = 0U; b < bands; b++)
+    {
+      for (t = 0U; t < 3U; t++)
+      {
+        sub = kurt_split(&cur[2U * b * len], len, bank.h3[t], KURT_TAPS3,
+                         3U, (t == 1U) ? 1U : 0U, next);
+        kurt_keep(best, kurt_value(next, sub, 2.0f), lvl, 1U,
+                  (uint16_t)((3U * b) + t), odr_hz);
+      }
+    }
+
+    /* halves of this level, stored band after band in next */
+    sub = ((len - KURT_TAPS2) / 2U) + 1U;
+    for (b = 0U; b < bands; b++)
+    {
+      for (t = 0U; t < 2U; t++)
+      {
+        (void)kurt_split(&cur[2U * b * len], len, bank.h2[t], KURT_TAPS2,
+                         2U, t, &next[2U * ((2U * b) + t) * sub]);
+      }
+    }
+
+    for (b = 0U; b < (2U * bands); b++)
+    {
+      kurt_keep(best, kurt_value(&next[2U * b * sub], sub, 2.0f), lvl + 1U,
+                0U, b, odr_hz);
+    }
+
+    tmp = cur;
+    cur = next;
+    next = tmp;
+    len = sub;
+    bands *= 2U;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Extract the squared envelope of one kurtogram band, e.g. the
+  *         best band found by iis3dwb_kurtogram_run, at the decimated
+  *         rate of the band (2 * bw_hz).
+  *
+  * @param  x       Samples.(ptr)
+  * @param  num     Number of samples.
+  * @param  stride  Distance between samples in x.
+  * @param  band    Kurtogram band.(ptr)
+  * @param  work    IIS3DWB_KURT_WORK_LEN(num) elements.(ptr)
+  * @param  env     Squared envelope, up to num / 2^level elements.(ptr)
+  * @param  len     Number of envelope samples.(ptr)
+  * @retval         0 -> envelope ready, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_kurtogram_envelope(const int16_t *x, uint32_t num,
+                                   uint8_t stride,
+                                   const iis3dwb_kurt_band_t *band,
+                                   float_t *work, float_t *env,
+                                   uint32_t *len)
+{
+  kurt_bank_t bank;
+  float_t *cur = work;
+  float_t *next = &work[2U * num];
+  float_t *tmp;
+  uint32_t path = band->band;
+  uint32_t n = num;
+  uint32_t m;
+  uint8_t bit;
+  uint8_t lvl;
+
+  *len = 0U;
+
+  if ((num < KURT_MIN_LEN) || (band->level > IIS3DWB_KURT_LEVELS_MAX))
+  {
+    return -1;
+  }
+
+  kurt_bank_init(&bank);
+  kurt_load(x, num, stride, cur);
+
+  /* a band in three comes from band / 3 of its binary level */
+  path = (band->third != 0U) ? (path / 3U) : path;
+
+  for (lvl = band->level; lvl > 0U; lvl--)
+  {
+    bit = (uint8_t)((path >> (lvl - 1U)) & 1U);
+    n = kurt_split(cur, n, bank.h2[bit], KURT_TAPS2, 2U, bit, next);
+    tmp = cur;
+    cur = next;
+    next = tmp;
+  }
+
+  if (band->third != 0U)
+  {
+    bit = (uint8_t)(band->band % 3U);
+    n = kurt_split(cur, n, bank.h3[bit], KURT_TAPS3, 3U,
+                   (bit == 1U) ? 1U : 0U, next);
+    cur = next;
+  }
+
+  for (m = 0U; m < n; m++)
+  {
+    env[m] = (cur[2U * m] * cur[2U * m]) +
+             (cur[(2U * m) + 1U] * cur[(2U * m) + 1U]);
+  }
+  *len = n;
+
+  return 0;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_tsa Time-Synchronous Averaging
+  * @brief      This section groups the functions that resample each shaft
+  *             revolution, delimited by once-per-rev pulses, to a fixed
+  *             number of points and average the revolutions, removing
+  *             the components not synchronous with the shaft.
+  *             The average is kept as a running mean in caller memory,
+  *             so its size does not depend on the number of revolutions.
+  * @{
+  *
+  */
+
+#define TSA_2PI               6.28318530718f
+
+/**
+  * @brief  Initialize a time-synchronous average.
+  *
+  * @param  tsa       Synchronous average.(ptr)
+  * @param  avg       Average, len elements.(ptr)
+  * @param  rev       Scratch revolution, len elements.(ptr)
+  * @param  len       Points per revolution (> 1), above twice the
+  *                   highest shaft order of interest.
+  * @param  max_revs  Revolutions averaged with equal weight, older ones
+  *                   then fade out exponentially; 0 -> all revolutions.
+  * @retval           0 -> average ready, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_tsa_init(iis3dwb_tsa_t *tsa, float_t *avg, float_t *rev,
+                         uint16_t len, uint32_t max_revs)
+{
+  if ((tsa == NULL) || (avg == NULL) || (rev == NULL) || (len < 2U))
+  {
+    return -1;
+  }
+
+  memset(tsa, 0, sizeof(iis3dwb_tsa_t));
+  memset(avg, 0, (uint32_t)len * sizeof(float_t));
+  tsa->avg = avg;
+  tsa->rev = rev;
+  tsa->len = len;
+  tsa->max_revs = max_revs;
+
+  return 0;
+}
+
+/**
+  * @brief  Add a once-per-rev pulse, in the time base of the sample
+  *         timestamps (e.g. iis3dwb_fifo_dec_run).
+  *
+  * @param  tsa    Synchronous average.(ptr)
+  * @param  t_ns   Pulse time (ns).
+  * @retval        0 -> pulse queued, -1 -> queue full or pulse older
+  *                than the previous one.
+  *
+  */
+int32_t iis3dwb_tsa_pulse_add(iis3dwb_tsa_t *tsa, uint64_t t_ns)
+{
+  if ((tsa->npulse == IIS3DWB_TSA_PULSES) ||
+      ((tsa->npulse > 0U) && (t_ns <= tsa->pulse[tsa->npulse - 1U])))
+  {
+    return -1;
+  }
+
+  tsa->pulse[tsa->npulse] = t_ns;
+  tsa->npulse++;
+
+  return 0;
+}
+
+/**
+  * @brief  Resample and average the revolutions covered by a block of
+  *         samples. A sample is consumed only when the pulse closing its
+  *         revolution is known; the others must be passed again once
+  *         the next pulse has been added.
+  *
+  * @param  tsa     Synchronous average.(ptr)
+  * @param  x       Samples.(ptr)
+  * @param  ts_ns   Time of each sample (ns).(ptr)
+  * @param  num     Number of samples.
+  * @param  stride  Distance between samples in x (3 for one axis of
+  *                 X, Y, Z samples).
+  * @retval         Samples consumed.
+  *
+  */
+uint32_t iis3dwb_tsa_run(iis3dwb_tsa_t *tsa, const int16_t *x,
+                         const uint64_t *ts_ns, uint32_t num,
+                         uint8_t stride)
+{
+  uint64_t dur;
+  uint64_t t;
+  float_t w;
+  float_t v;
+  uint32_t n;
+  uint16_t j;
+  uint8_t i;
+
+  for (n = 0U; (n < num) && (tsa->npulse > 0U) &&
+       (ts_ns[n] <= tsa->pulse[tsa->npulse - 1U]); n++)
+  {
+    v = (float_t)x[n * stride];
+
+    while ((tsa->npulse > 1U) && (tsa->prev_valid != 0U))
+    {
+      dur = tsa->pulse[1] - tsa->pulse[0];
+      t = tsa->pulse[0] + ((dur * tsa->pos) / tsa->len);
+
+      if (t > ts_ns[n])
+      {
+        break;
+      }
+
+      /* linear interpolation between the last two samples */
+      w = (t > tsa->prev_ts) ? ((float_t)(t - tsa->prev_ts) /
+                                (float_t)(ts_ns[n] - tsa->prev_ts)) : 0.0f;
+      tsa->rev[tsa->pos] = tsa->prev_x + (w * (v - tsa->prev_x));
+      tsa->pos++;
+
+      if (tsa->pos == tsa->len)
+      {
+        tsa->revs++;
+        w = ((tsa->max_revs != 0U) && (tsa->revs > tsa->max_revs)) ?
+            (1.0f / (float_t)tsa->max_revs) : (1.0f / (float_t)tsa->revs);
+
+        for (j = 0U; j < tsa->len; j++)
+        {
+          tsa->avg[j] += w * (tsa->rev[j] - tsa->avg[j]);
+        }
+
+        for (i = 1U; i < tsa->npulse; i++)
+        {
+          tsa->pulse[i - 1U] = tsa->pulse[i];
+        }
+        tsa->npulse--;
+        tsa->pos = 0U;
+      }
+    }
+
+    tsa->prev_x = v;
+    tsa->prev_ts = ts_ns[n];
+    tsa->prev_valid = 1U;
+  }
+
+  return n;
+}
+
+/* remove shaft order r of a len points revolution; orders 0 and len / 2
+ * have no conjugate image, so their projection is not doubled
+ */
+static void tsa_order_remove(float_t *out, uint16_t len, uint32_t r)
+{
+  const float_t k = TSA_2PI / (float_t)len;
+  float_t a = 0.0f;
+  float_t b = 0.0f;
+  float_t s = ((r == 0U) || ((2U * r) == len)) ? 1.0f : 2.0f;
+  uint32_t ph;
+  uint16_t n;
+
+  for (n = 0U; n < len; n++)
+  {
+    ph = (r * n) % len;
+    a += out[n] * cosf(k * (float_t)ph);
+    b += out[n] * sinf(k * (float_t)ph);
+  }
+
+  s /= (float_t)len;
+  for (n = 0U; n < len; n++)
+  {
+    ph = (r * n) % len;
+    out[n] -= s * ((a * cosf(k * (float_t)ph)) + (b * sinf(k * (float_t)ph)));
+  }
+}
+
+/**
+  * @brief  Residual or difference signal of the synchronous average:
+  *         the average without its mean, the shaft order and the gear
+  *         mesh harmonics (residual), and also without their first
+  *         sidebands (difference, sidebands = 1).
+  *
+  * @param  tsa        Synchronous average.(ptr)
+  * @param  mesh       Gear mesh order (number of teeth).
+  * @param  harmonics  Mesh harmonics removed.
+  * @param  sidebands  Sidebands removed around each harmonic.
+  * @param  out        Signal, len elements.(ptr)
+  * @retval            0 -> signal ready, -1 -> no revolution averaged
+  *                    or orders above len / 2.
+  *
+  */
+int32_t iis3dwb_tsa_residual(const iis3dwb_tsa_t *tsa, uint16_t mesh,
+                             uint8_t harmonics, uint8_t sidebands,
+                             float_t *out)
+{
+  uint32_t r;
+  uint8_t h;
+  uint8_t s;
+
+  if ((tsa->revs == 0U) ||
+      ((2U * (((uint32_t)mesh * harmonics) + sidebands)) > tsa->len))
+  {
+    return -1;
+  }
+
+  memcpy(out, tsa->avg, (uint32_t)tsa->len * sizeof(float_t));
+
+  /* orders are removed from the partly cleaned signal, so an order
+   * listed twice (e.g. mesh - 1 = 1) is removed once
+   */
+  tsa_order_remove(out, tsa->len, 0U);
+  tsa_order_remove(out, tsa->len, 1U);
+
+  for (h = 1U; h <= harmonics; h++)
+  {
+    r = (uint32_t)mesh * h;
+    tsa_order_remove(out, tsa->len, r);
+
+    for (s = 1U; (s <= sidebands) && (s < r); s++)
+    {
+      tsa_order_remove(out, tsa->len, r - s);
+      tsa_order_remove(out, tsa->len, r + s);
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_spec_store Spectrogram Store
+  * @brief      This section groups the functions that keep the last
+  *             spectra of a sensor in a fixed memory ring, as float or
+  *             quantized dB, for scrolling waterfalls.
+  *             Spectra are addressed by their append index; the oldest
+  *             ones are overwritten once the ring is full.
+  * @{
+  *
+  */
+
+#define SPEC_DB_FLOOR         1.0e-6f
+
+static uint8_t *spec_row(const iis3dwb_spec_store_t *st, uint32_t idx)
+{
+  return &st->mem[(idx % st->rows) * st->row_size];
+}
+
+static uint32_t spec_oldest(const iis3dwb_spec_store_t *st)
+{
+  return (st->head > st->rows) ? (st->head - st->rows) : 0U;
+}
+
+static float_t spec_bin_get(const iis3dwb_spec_store_t *st,
+                            const uint8_t *row, uint16_t k)
+{
+  const void *data = &row[8];
+  float_t db;
+
+  switch (st->fmt)
+  {
+    case IIS3DWB_SPEC_DB16:
+      db = st->db_min + (st->db_step * (float_t)((const uint16_t *)data)[k]);
+      break;
+
+    case IIS3DWB_SPEC_DB8:
+      db = st->db_min + (st->db_step * (float_t)((const uint8_t *)data)[k]);
+      break;
+
+    case IIS3DWB_SPEC_F32:
+    default:
+      db = ((const float_t *)data)[k];
+      break;
+  }
+
+  return db;
+}
+
+/**
+  * @brief  Initialize a spectrogram store.
+  *
+  * @param  st       Spectrogram store.(ptr)
+  * @param  mem      Ring memory, 8 bytes aligned.(ptr)
+  * @param  size     Ring memory size in bytes, at least two rows of
+  *                  IIS3DWB_SPEC_ROW_SIZE(bins, fmt).
+  * @param  bins     Bins per spectrum.
+  * @param  fmt      IIS3DWB_SPEC_F32, IIS3DWB_SPEC_DB16, IIS3DWB_SPEC_DB8.
+  * @param  db_min   Quantized formats: dB of code 0.
+  * @param  db_step  Quantized formats: dB per code (> 0).
+  * @retval          0 -> store ready, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_spec_store_init(iis3dwb_spec_store_t *st, void *mem,
+                                uint32_t size, uint16_t bins,
+                                iis3dwb_spec_fmt_t fmt, float_t db_min,
+                                float_t db_step)
+{
+  const uint32_t row_size = IIS3DWB_SPEC_ROW_SIZE(bins, fmt);
+
+  if ((st == NULL) || (mem == NULL) || (bins == 0U) ||
+      (size < (2U * row_size)) ||
+      ((fmt != IIS3DWB_SPEC_F32) && (db_step <= 0.0f)))
+  {
+    return -1;
+  }
+
+  st->mem = (uint8_t *)mem;
+  st->rows = size / row_size;
+  st->row_size = row_size;
+  st->head = 0U;
+  st->bins = bins;
+  st->fmt = fmt;
+  st->db_min = db_min;
+  st->db_step = db_step;
+
+  return 0;
+}
+
+/**
+  * @brief  Append a spectrum, overwriting the oldest one when full.
+  *
+  * @param  st     Spectrogram store.(ptr)
+  * @param  mag    Linear magnitude of each bin, e.g. FFT output.(ptr)
+  * @param  t_ns   Time of the spectrum (ns), non decreasing.
+  *
+  */
+void iis3dwb_spec_store_append(iis3dwb_spec_store_t *st, const float_t *mag,
+                               uint64_t t_ns)
+{
+  uint8_t *row = spec_row(st, st->head);
+  void *data = &row[8];
+  const float_t qmax = (st->fmt == IIS3DWB_SPEC_DB16) ? 65535.0f : 255.0f;
+  float_t db;
+  float_t q;
+  uint16_t k;
+
+  memcpy(row, &t_ns, sizeof(uint64_t));
+
+  for (k = 0U; k < st->bins; k++)
+  {
+    db = 20.0f * log10f((mag[k] > SPEC_DB_FLOOR) ? mag[k] : SPEC_DB_FLOOR);
+
+    if (st->fmt == IIS3DWB_SPEC_F32)
+    {
+      ((float_t *)data)[k] = db;
+    }
+    else
+    {
+      q = ((db - st->db_min) / st->db_step) + 0.5f;
+      q = (q < 0.0f) ? 0.0f : ((q > qmax) ? qmax : q);
+
+      if (st->fmt == IIS3DWB_SPEC_DB16)
+      {
+        ((uint16_t *)data)[k] = (uint16_t)q;
+      }
+      else
+      {
+        ((uint8_t *)data)[k] = (uint8_t)q;
+      }
+    }
+  }
+
+  st->head++;
+}
+
+/**
+  * @brief  Index of the first retained spectrum at or after a time.
+  *
+  * @param  st     Spectrogram store.(ptr)
+  * @param  t_ns   Time (ns).
+  * @param  idx    Spectrum index.(ptr)
+  * @retval        0 -> found, -1 -> no retained spectrum at or after t_ns.
+  *
+  */
+int32_t iis3dwb_spec_store_find(const iis3dwb_spec_store_t *st,
+                                uint64_t t_ns, uint32_t *idx)
+{
+  uint32_t lo = spec_oldest(st);
+  uint32_t hi = st->head;
+  uint32_t mid;
+  uint64_t t;
+
+  while (lo < hi)
+  {
+    mid = lo + ((hi - lo) / 2U);
+    memcpy(&t, spec_row(st, mid), sizeof(uint64_t));
+
+    if (t < t_ns)
+    {
+      lo = mid + 1U;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  *idx = lo;
+
+  return (lo < st->head) ? 0 : -1;
+}
+
+/**
+  * @brief  Read a retained spectrum.
+  *
+  * @param  st     Spectrogram store.(ptr)
+  * @param  idx    Spectrum index.
+  * @param  db     Bins in dB, bins elements.(ptr)
+  * @param  t_ns   Time of the spectrum (ns), NULL if not needed.(ptr)
+  * @retval        0 -> read, -1 -> spectrum not (or no longer) stored.
+  *
+  */
+int32_t iis3dwb_spec_store_read(const iis3dwb_spec_store_t *st, uint32_t idx,
+                                float_t *db, uint64_t *t_ns)
+{
+  const uint8_t *row;
+  uint16_t k;
+
+  if ((idx < spec_oldest(st)) || (idx >= st->head))
+  {
+    return -1;
+  }
+
+  row = spec_row(st, idx);
+  if (t_ns != NULL)
+  {
+    memcpy(t_ns, row, sizeof(uint64_t));
+  }
+
+  for (k = 0U; k < st->bins; k++)
+  {
+    db[k] = spec_bin_get(st, row, k);
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Downsampled view of a range of spectra: each output cell is
+  *         the maximum over row_dec spectra and bin_dec bins, so narrow
+  *         peaks remain visible in the waterfall.
+  *
+  * @param  st       Spectrogram store.(ptr)
+  * @param  first    Index of the first spectrum.
+  * @param  num      Number of spectra.
+  * @param  row_dec  Spectra per output row (> 0).
+  * @param  bin_dec  Bins per output column (> 0).
+  * @param  db       Output, (num / row_dec) rows of (bins / bin_dec)
+  *                  columns, rounded up.(ptr)
+  * @retval          0 -> view ready, -1 -> range not stored.
+  *
+  */
+int32_t iis3dwb_spec_store_view(const iis3dwb_spec_store_t *st,
+                                uint32_t first, uint32_t num,
+                                uint16_t row_dec, uint16_t bin_dec,
+                                float_t *db)
+{
+  const uint32_t cols = ((uint32_t)st->bins + bin_dec - 1U) / bin_dec;
+  const uint8_t *row;
+  float_t *out;
+  float_t v;
+  uint32_t n;
+  uint16_t k;
+
+  if ((row_dec == 0U) || (bin_dec == 0U) || (first < spec_oldest(st)) ||
+      (first > st->head) || (num > (st->head - first)))
+  {
+    return -1;
+  }
+
+  for (n = 0U; n < num; n++)
+  {
+    row = spec_row(st, first + n);
+    out = &db[(n / row_dec) * cols];
+
+    for (k = 0U; k < st->bins; k++)
+    {
+      v = spec_bin_get(st, row, k);
+
+      if (((n % row_dec) == 0U) && ((k % bin_dec) == 0U))
+      {
+        out[k / bin_dec] = v;
+      }
+      else
+      {
+        out[k / bin_dec] = (v > out[k / bin_dec]) ? v : out[k / bin_dec];
+      }
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_peaks Spectral Peak Detection
+  * @brief      This section groups the functions that reduce a magnitude
+  *             spectrum to a short list of peaks, with sub-bin frequency,
+  *             harmonic families and sideband spacing, for automated
+  *             alarms.
+  * @{
+  *
+  */
+
+#define PEAK_MIN_HARMONICS    2U
+
+/* peaks in increasing frequency order */
+static void peak_sort(const iis3dwb_peak_t *peak, uint8_t num,
+                      uint8_t *by_freq)
+{
+  uint8_t i;
+  uint8_t j;
+
+  for (i = 0U; i < num; i++)
+  {
+    for (j = i; (j > 0U) &&
+         (peak[by_freq[j - 1U]].freq_hz > peak[i].freq_hz); j--)
+    {
+      by_freq[j] = by_freq[j - 1U];
+    }
+    by_freq[j] = i;
+  }
+}
+
+/* 1 -> a peak lies within tol_hz of freq_hz (binary search) */
+static uint8_t peak_at(const iis3dwb_peak_t *peak, const uint8_t *by_freq,
+                       uint8_t num, float_t freq_hz, float_t tol_hz)
+{
+  uint8_t lo = 0U;
+  uint8_t hi = num;
+  uint8_t mid;
+
+  while (lo < hi)
+  {
+    mid = lo + ((hi - lo) / 2U);
+
+    if (peak[by_freq[mid]].freq_hz < (freq_hz - tol_hz))
+    {
+      lo = mid + 1U;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return ((lo < num) &&
+          (peak[by_freq[lo]].freq_hz <= (freq_hz + tol_hz))) ? 1U : 0U;
+}
+
+/* order of peak p in the harmonic series of f0, 0 -> not a harmonic */
+static uint8_t peak_order(const iis3dwb_peak_t *p, float_t f0, float_t tol_hz)
+{
+  const float_t r = (p->freq_hz / f0) + 0.5f;
+  uint8_t n = 0U;
+
+  if ((p->family == IIS3DWB_PEAK_NO_FAMILY) && (r >= 2.0f) && (r < 256.0f))
+  {
+    n = (uint8_t)r;
+    n = (fabsf(p->freq_hz - ((float_t)n * f0)) <= ((float_t)n * tol_hz)) ?
+        n : 0U;
+  }
+
+  return n;
+}
+
+/* fundamentals are tried from the lowest frequency upward */
+static void peak_families(iis3dwb_peak_t *peak, const uint8_t *by_freq,
+                          uint8_t num, float_t tol_hz)
+{
+  uint8_t members;
+  float_t f0;
+  uint8_t i;
+  uint8_t j;
+  uint8_t k;
+  uint8_t n;
+
+  for (i = 0U; i < num; i++)
+  {
+    k = by_freq[i];
+    f0 = peak[k].freq_hz;
+    members = 0U;
+
+    if ((peak[k].family == IIS3DWB_PEAK_NO_FAMILY) && (f0 > 0.0f))
+    {
+      for (j = 0U; j < num; j++)
+      {
+        members += (peak_order(&peak[j], f0, tol_hz) != 0U) ? 1U : 0U;
+      }
+    }
+
+    if (members >= PEAK_MIN_HARMONICS)
+    {
+      for (j = 0U; j < num; j++)
+      {
+        n = peak_order(&peak[j], f0, tol_hz);
+        if (n != 0U)
+        {
+          peak[j].family = k;
+          peak[j].order = n;
+        }
+      }
+      peak[k].family = k;
+      peak[k].order = 1U;
+    }
+  }
+}
+
+/* 1 -> lo, c, hi are consecutive orders of one harmonic family */
+static uint8_t peak_in_series(const iis3dwb_peak_t *lo,
+                              const iis3dwb_peak_t *c,
+                              const iis3dwb_peak_t *hi)
+{
+  return ((c->family != IIS3DWB_PEAK_NO_FAMILY) &&
+          (lo->family == c->family) && (hi->family == c->family) &&
+          ((lo->order + 1U) == c->order) &&
+          ((c->order + 1U) == hi->order)) ? 1U : 0U;
+}
+
+/* the adjacent peaks, at the same distance, set the sideband spacing */
+static void peak_sidebands(iis3dwb_peak_t *peak, const uint8_t *by_freq,
+                           uint8_t num, float_t tol_hz)
+{
+  iis3dwb_peak_t *c;
+  const iis3dwb_peak_t *lo;
+  const iis3dwb_peak_t *hi;
+  float_t df;
+  uint8_t i;
+  uint8_t n;
+
+  for (i = 1U; (i + 1U) < num; i++)
+  {
+    c = &peak[by_freq[i]];
+    lo = &peak[by_freq[i - 1U]];
+    hi = &peak[by_freq[i + 1U]];
+    df = 0.5f * (hi->freq_hz - lo->freq_hz);
+
+    /* a carrier dominates its sidebands */
+    if ((fabsf((c->freq_hz - lo->freq_hz) - df) <= tol_hz) &&
+        (df > tol_hz) && (c->amp > lo->amp) && (c->amp > hi->amp) &&
+        (peak_in_series(lo, c, hi) == 0U))
+    {
+      c->sb_hz = df;
+      c->sidebands = 1U;
+
+      /* further pairs at f +/- n * spacing */
+      for (n = 2U; (n < 0xFFU) &&
+           (peak_at(peak, by_freq, num, c->freq_hz + ((float_t)n * df),
+                    tol_hz) != 0U) &&
+           (peak_at(peak, by_freq, num, c->freq_hz - ((float_t)n * df),
+                    tol_hz) != 0U); n++)
+      {
+        c->sidebands = n;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Find the strongest peaks of a magnitude spectrum, refine
+  *         their frequency and magnitude by parabolic interpolation of
+  *         the log magnitude, then group them in harmonic families and
+  *         measure the sideband spacing around each peak.
+  *
+  * @param  mag     Magnitude of bins 0 .. bins - 1, e.g. FFT output.(ptr)
+  * @param  bins    Number of bins.
+  * @param  bin_hz  Bin width (Hz).
+  * @param  thr     Min peak magnitude relative to the spectrum mean.
+  * @param  tol_hz  Frequency tolerance of harmonics (per order) and
+  *                 sidebands.
+  * @param  peak    Peaks, by decreasing magnitude.(ptr)
+  * @param  max     Max number of peaks (1 .. 254, 255 is
+  *                 IIS3DWB_PEAK_NO_FAMILY).
+  * @retval         Number of peaks found.
+  *
+  */
+uint8_t iis3dwb_peaks_find(const float_t *mag, uint16_t bins, float_t bin_hz,
+                           float_t thr, float_t tol_hz, iis3dwb_peak_t *peak,
+                           uint8_t max)
+{
+  uint8_t by_freq[IIS3DWB_PEAK_NO_FAMILY];
+  float_t floor_mag = 0.0f;
+  float_t amp;
+  float_t a;
+  float_t b;
+  float_t c;
+  float_t d;
+  uint8_t num = 0U;
+  uint8_t i;
+  uint16_t k;
+
+  if ((bins < 3U) || (max == 0U) || (max == IIS3DWB_PEAK_NO_FAMILY))
+  {
+    return 0U;
+  }
+
+  for (k = 0U; k < bins; k++)
+  {
+    floor_mag += mag[k];
+  }
+  floor_mag = thr * floor_mag / (float_t)bins;
+
+  for (k = 1U; k < (bins - 1U); k++)
+  {
+    if ((mag[k] > floor_mag) && (mag[k] > mag[k - 1U]) &&
+        (mag[k] >= mag[k + 1U]))
+    {
+      /* parabola through the log magnitude of the three bins */
+      a = logf((mag[k - 1U] > 0.0f) ? mag[k - 1U] : 1.0e-20f);
+      b = logf(mag[k]);
+      c = logf((mag[k + 1U] > 0.0f) ? mag[k + 1U] : 1.0e-20f);
+      d = a - (2.0f * b) + c;
+      d = (d < 0.0f) ? ((0.5f * (a - c)) / d) : 0.0f;
+      amp = expf(b - (0.25f * (a - c) * d));
+
+      if ((num < max) || (amp > peak[num - 1U].amp))
+      {
+        /* insert by decreasing magnitude, the weakest drops out */
+        i = (num < max) ? num : (max - 1U);
+        num = (num < max) ? (num + 1U) : num;
+        for (; (i > 0U) && (peak[i - 1U].amp < amp); i--)
+        {
+          peak[i] = peak[i - 1U];
+        }
+
+        peak[i].freq_hz = ((float_t)k + d) * bin_hz;
+        peak[i].amp = amp;
+        peak[i].sb_hz = 0.0f;
+        peak[i].family = IIS3DWB_PEAK_NO_FAMILY;
+        peak[i].order = 0U;
+        peak[i].sidebands = 0U;
+      }
+    }
+  }
+
+  peak_sort(peak, num, by_freq);
+  peak_families(peak, by_freq, num, tol_hz);
+  peak_sidebands(peak, by_freq, num, tol_hz);
+
+  return num;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @}
+  *
+  */
@@ -0,0 +1,183 @@
+/**
+  ******************************************************************************
+  * @file    iis3dwb_dsp.h
+  * @author  Sensors Software Solution Team
+  * @brief   This file contains all the functions prototypes for the
+  *          iis3dwb_dsp.c optional signal processing module.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef IIS3DWB_DSP_H
+#define IIS3DWB_DSP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "iis3dwb_reg.h"
+
+/** @addtogroup IIS3DWB_DSP
+  * @{
+  *
+  */
+
+#ifndef IIS3DWB_GOERTZEL_BINS
+#define IIS3DWB_GOERTZEL_BINS                50U
+#endif /* IIS3DWB_GOERTZEL_BINS */
+
+typedef struct
+{
+  float_t coeff[IIS3DWB_GOERTZEL_BINS];   /* 2 cos(w) */
+  float_t cos_w[IIS3DWB_GOERTZEL_BINS];
+  float_t sin_w[IIS3DWB_GOERTZEL_BINS];
+  float_t s1[IIS3DWB_GOERTZEL_BINS];
+  float_t s2[IIS3DWB_GOERTZEL_BINS];
+  float_t w_end[IIS3DWB_GOERTZEL_BINS];   /* w (block_len - 1) mod 2 pi */
+  uint8_t num;              /* number of bins */
+  uint32_t block_len;       /* samples per block */
+  uint32_t cnt;             /* samples of the current block */
+} iis3dwb_goertzel_t;
+
+typedef struct
+{
+  float_t amp;              /* peak amplitude, unit of the samples */
+  float_t phase;            /* rad, at the first sample of the block */
+} iis3dwb_goertzel_out_t;
+int32_t iis3dwb_goertzel_init(iis3dwb_goertzel_t *g, const float_t *freq_hz,
+                              uint8_t num, float_t odr_hz,
+                              uint32_t block_len);
+uint8_t iis3dwb_goertzel_run(iis3dwb_goertzel_t *g, const int16_t *x,
+                             uint32_t *num, uint8_t stride,
+                             iis3dwb_goertzel_out_t *out);
+
+#ifndef IIS3DWB_KURT_LEVELS_MAX
+#define IIS3DWB_KURT_LEVELS_MAX              8U
+#endif /* IIS3DWB_KURT_LEVELS_MAX */
+
+/* float_t elements of the kurtogram work buffer for n samples */
+#define IIS3DWB_KURT_WORK_LEN(n)             (4U * (uint32_t)(n))
+
+typedef struct
+{
+  float_t kurt;             /* spectral kurtosis of the band */
+  float_t fc_hz;            /* band center */
+  float_t bw_hz;            /* band width */
+  uint8_t level;            /* binary level: odr / 2^(level + 1) wide */
+  uint8_t third;            /* 1 -> binary level split in three */
+  uint16_t band;            /* band index, from 0 Hz upward */
+} iis3dwb_kurt_band_t;
+int32_t iis3dwb_kurtogram_run(const int16_t *x, uint32_t num,
+                              uint8_t stride, uint8_t levels, float_t odr_hz,
+                              float_t *work, iis3dwb_kurt_band_t *best);
+int32_t iis3dwb_kurtogram_envelope(const int16_t *x, uint32_t num,
+                                   uint8_t stride,
+                                   const iis3dwb_kurt_band_t *band,
+                                   float_t *work, float_t *env,
+                                   uint32_t *len);
+
+#ifndef IIS3DWB_TSA_PULSES
+#define IIS3DWB_TSA_PULSES                   8U
+#endif /* IIS3DWB_TSA_PULSES */
+
+typedef struct
+{
+  float_t *avg;             /* len elements: synchronous average */
+  float_t *rev;             /* len elements: revolution being resampled */
+  uint16_t len;             /* points per revolution */
+  uint16_t pos;             /* next point of the revolution */
+  uint32_t revs;            /* revolutions averaged */
+  uint32_t max_revs;        /* averaging depth, 0 -> unbounded */
+  uint64_t pulse[IIS3DWB_TSA_PULSES];   /* once-per-rev times (ns) */
+  uint8_t npulse;
+  uint8_t prev_valid;
+  float_t prev_x;           /* last sample, for the interpolation */
+  uint64_t prev_ts;
+} iis3dwb_tsa_t;
+int32_t iis3dwb_tsa_init(iis3dwb_tsa_t *tsa, float_t *avg, float_t *rev,
+                         uint16_t len, uint32_t max_revs);
+int32_t iis3dwb_tsa_pulse_add(iis3dwb_tsa_t *tsa, uint64_t t_ns);
+uint32_t iis3dwb_tsa_run(iis3dwb_tsa_t *tsa, const int16_t *x,
+                         const uint64_t *ts_ns, uint32_t num,
+                         uint8_t stride);
+int32_t iis3dwb_tsa_residual(const iis3dwb_tsa_t *tsa, uint16_t mesh,
+                             uint8_t harmonics, uint8_t sidebands,
+                             float_t *out);
+
+typedef enum
+{
+  IIS3DWB_SPEC_F32   = 0,   /* float dB */
+  IIS3DWB_SPEC_DB16  = 1,   /* 16-bit quantized dB */
+  IIS3DWB_SPEC_DB8   = 2,   /* 8-bit quantized dB */
+} iis3dwb_spec_fmt_t;
+
+/* bytes of one stored bin, and of one spectrum: timestamp and bins,
+ * 8 bytes aligned
+ */
+#define IIS3DWB_SPEC_BIN_SIZE(fmt)           (((fmt) == IIS3DWB_SPEC_F32) ? 4U : \
+                                              (((fmt) == IIS3DWB_SPEC_DB16) ? 2U : 1U))
+#define IIS3DWB_SPEC_ROW_SIZE(bins, fmt)     ((8U + ((uint32_t)(bins) * \
+                                               IIS3DWB_SPEC_BIN_SIZE(fmt)) + 7U) & ~7U)
+
+typedef struct
+{
+  uint8_t *mem;             /* rows * IIS3DWB_SPEC_ROW_SIZE bytes */
+  uint32_t rows;            /* spectra retained */
+  uint32_t row_size;
+  uint32_t head;            /* spectra appended since the initialization */
+  uint16_t bins;
+  iis3dwb_spec_fmt_t fmt;
+  float_t db_min;           /* quantized dB: db_min + q * db_step */
+  float_t db_step;
+} iis3dwb_spec_store_t;
+int32_t iis3dwb_spec_store_init(iis3dwb_spec_store_t *st, void *mem,
+                                uint32_t size, uint16_t bins,
+                                iis3dwb_spec_fmt_t fmt, float_t db_min,
+                                float_t db_step);
+void iis3dwb_spec_store_append(iis3dwb_spec_store_t *st, const float_t *mag,
+                               uint64_t t_ns);
+int32_t iis3dwb_spec_store_find(const iis3dwb_spec_store_t *st,
+                                uint64_t t_ns, uint32_t *idx);
+int32_t iis3dwb_spec_store_read(const iis3dwb_spec_store_t *st, uint32_t idx,
+                                float_t *db, uint64_t *t_ns);
+int32_t iis3dwb_spec_store_view(const iis3dwb_spec_store_t *st,
+                                uint32_t first, uint32_t num,
+                                uint16_t row_dec, uint16_t bin_dec,
+                                float_t *db);
+
+#define IIS3DWB_PEAK_NO_FAMILY               0xFFU
+
+typedef struct
+{
+  float_t freq_hz;          /* interpolated peak frequency */
+  float_t amp;              /* interpolated peak magnitude */
+  float_t sb_hz;            /* sideband spacing, 0 -> no sidebands */
+  uint8_t family;           /* peak index of the family fundamental */
+  uint8_t order;            /* harmonic order in the family */
+  uint8_t sidebands;        /* sideband pairs around the peak */
+} iis3dwb_peak_t;
+uint8_t iis3dwb_peaks_find(const float_t *mag, uint16_t bins, float_t bin_hz,
+                           float_t thr, float_t tol_hz, iis3dwb_peak_t *peak,
+                           uint8_t max);
+
+/**
+  *@}
+  *
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IIS3DWB_DSP_H */
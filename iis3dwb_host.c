@@ -0,0 +1,790 @@
+/**
+  ******************************************************************************
+  * @file    iis3dwb_host.c
+  * @author  Sensors Software Solution Team
+  * @brief   IIS3DWB optional host-side acquisition monitoring
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+#include "iis3dwb_host.h"
+#include <string.h>
+
+/**
+  * @defgroup    IIS3DWB_HOST IIS3DWB Host Monitoring
+  * @brief       This file provides optional host-side functions that
+  *              observe the acquisition of one or more iis3dwb devices:
+  *              health metrics and their export, throughput budget.
+  * @{
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_metrics Acquisition Health Metrics
+  * @brief      This section groups the functions that count FIFO overruns,
+  *             watermark hits, fill levels, drain latency, decode errors
+  *             and throughput of one device, from the values the drain
+  *             and decode paths already have.
+  *             Updates and snapshots are lock free: a single writer bumps
+  *             a sequence counter around each update and readers retry
+  *             a snapshot taken while it was odd or changed.
+  * @{
+  *
+  */
+
+#define METRICS_SNAP_TRIES    3U
+#define METRICS_OUT_LEN       64U
+#define METRICS_COUNTERS      8U
+
+typedef struct
+{
+  iis3dwb_metrics_write_t write;
+  void *arg;
+  char buf[METRICS_OUT_LEN];
+  uint16_t len;
+  int32_t ret;
+} metrics_out_t;
+
+static void metrics_flush(metrics_out_t *out)
+{
+  if ((out->ret == 0) && (out->len > 0U))
+  {
+    out->ret = out->write(out->arg, out->buf, out->len);
+  }
+  out->len = 0U;
+}
+
+static void metrics_puts(metrics_out_t *out, const char *str)
+{
+  const char *s = str;
+
+  while ((*s != '\0') && (out->ret == 0))
+  {
+    if (out->len == METRICS_OUT_LEN)
+    {
+      metrics_flush(out);
+    }
+    out->buf[out->len] = *s;
+    out->len++;
+    s++;
+  }
+}
+
+static void metrics_putu(metrics_out_t *out, uint64_t val)
+{
+  char dec[21];
+  uint64_t v = val;
+  uint8_t i = 20U;
+
+  dec[20] = '\0';
+  do
+  {
+    i--;
+    dec[i] = (char)('0' + (char)(v % 10U));
+    v /= 10U;
+  } while (v != 0U);
+
+  metrics_puts(out, &dec[i]);
+}
+
+static uint64_t metrics_counter(const iis3dwb_metrics_data_t *d, uint8_t id)
+{
+  uint64_t val;
+
+  switch (id)
+  {
+    case 0:
+      val = d->drains;
+      break;
+
+    case 1:
+      val = d->fifo_ovr;
+      break;
+
+    case 2:
+      val = d->fifo_full;
+      break;
+
+    case 3:
+      val = d->wtm_hits;
+      break;
+
+    case 4:
+      val = d->words;
+      break;
+
+    case 5:
+      val = d->samples;
+      break;
+
+    case 6:
+      val = d->decode_err;
+      break;
+
+    default:
+      val = d->bytes;
+      break;
+  }
+
+  return val;
+}
+
+static uint64_t metrics_rate(const iis3dwb_metrics_data_t *d,
+                             uint32_t tick_hz)
+{
+  const uint32_t elapsed = d->last_tick - d->first_tick;
+  uint64_t bps = 0U;
+
+  if ((tick_hz != 0U) && (elapsed != 0U))
+  {
+    bps = ((d->bytes / elapsed) * tick_hz) +
+          (((d->bytes % elapsed) * tick_hz) / elapsed);
+  }
+
+  return bps;
+}
+
+/* text sample: iis3dwb_<name><suffix>{sensor="<sensor>"[,<label>]} <val> */
+static void metrics_sample(metrics_out_t *out, const char *name,
+                           const char *suffix, const char *sensor,
+                           const char *label, uint64_t val)
+{
+  metrics_puts(out, "iis3dwb_");
+  metrics_puts(out, name);
+  metrics_puts(out, suffix);
+  metrics_puts(out, "{sensor=\"");
+  metrics_puts(out, sensor);
+  metrics_puts(out, "\"");
+  if (label != NULL)
+  {
+    metrics_puts(out, ",");
+    metrics_puts(out, label);
+  }
+  metrics_puts(out, "} ");
+  metrics_putu(out, val);
+  metrics_puts(out, "\n");
+}
+
+static void metrics_type(metrics_out_t *out, const char *name,
+                         const char *type)
+{
+  metrics_puts(out, "# TYPE iis3dwb_");
+  metrics_puts(out, name);
+  metrics_puts(out, " ");
+  metrics_puts(out, type);
+  metrics_puts(out, "\n");
+}
+
+/* JSON member: ,"<name>":<val> */
+static void metrics_member(metrics_out_t *out, const char *name,
+                           uint64_t val)
+{
+  metrics_puts(out, ",\"");
+  metrics_puts(out, name);
+  metrics_puts(out, "\":");
+  metrics_putu(out, val);
+}
+
+static const char *const metrics_name[METRICS_COUNTERS] =
+{
+  "fifo_drains_total", "fifo_ovr_total", "fifo_full_total",
+  "fifo_wtm_total", "fifo_words_total", "xl_samples_total",
+  "decode_errors_total", "fifo_bytes_total",
+};
+
+/* FIFO fill buckets: 32 words wide, the last one up to the full FIFO */
+static const char *const metrics_le[IIS3DWB_METRICS_FILL_BUCKETS] =
+{
+  "31", "63", "95", "127", "159", "191", "223", "255", "287", "319",
+  "351", "383", "415", "447", "479", "512",
+};
+
+static const char *const metrics_quantile[3] = { "0.5", "0.99", "1" };
+static const uint8_t metrics_pct[3] = { 50U, 99U, 100U };
+
+static void metrics_text(metrics_out_t *out,
+                         const iis3dwb_metrics_data_t *snap,
+                         const char *const *sensor, uint8_t num,
+                         uint32_t tick_hz)
+{
+  char label[24];
+  uint64_t cum;
+  uint8_t i;
+  uint8_t k;
+  uint8_t s;
+
+  for (k = 0U; k < METRICS_COUNTERS; k++)
+  {
+    metrics_type(out, metrics_name[k], "counter");
+    for (s = 0U; s < num; s++)
+    {
+      metrics_sample(out, metrics_name[k], "", sensor[s], NULL,
+                     metrics_counter(&snap[s], k));
+    }
+  }
+
+  metrics_type(out, "fifo_bytes_per_second", "gauge");
+  for (s = 0U; s < num; s++)
+  {
+    metrics_sample(out, "fifo_bytes_per_second", "", sensor[s], NULL,
+                   metrics_rate(&snap[s], tick_hz));
+  }
+
+  /* last bucket is the whole FIFO, exported as +Inf */
+  metrics_type(out, "fifo_fill_words", "histogram");
+  for (s = 0U; s < num; s++)
+  {
+    cum = 0U;
+    for (i = 0U; i < IIS3DWB_METRICS_FILL_BUCKETS; i++)
+    {
+      cum += snap[s].fill[i];
+      (void)strcpy(label, "le=\"");
+      (void)strcat(label, ((i + 1U) == IIS3DWB_METRICS_FILL_BUCKETS) ?
+                   "+Inf" : metrics_le[i]);
+      (void)strcat(label, "\"");
+      metrics_sample(out, "fifo_fill_words", "_bucket", sensor[s], label,
+                     cum);
+    }
+    metrics_sample(out, "fifo_fill_words", "_sum", sensor[s], NULL,
+                   snap[s].fill_sum);
+    metrics_sample(out, "fifo_fill_words", "_count", sensor[s], NULL, cum);
+  }
+
+  metrics_type(out, "drain_latency_ticks", "summary");
+  for (s = 0U; s < num; s++)
+  {
+    for (i = 0U; i < 3U; i++)
+    {
+      (void)strcpy(label, "quantile=\"");
+      (void)strcat(label, metrics_quantile[i]);
+      (void)strcat(label, "\"");
+      metrics_sample(out, "drain_latency_ticks", "", sensor[s], label,
+                     iis3dwb_lat_hist_percentile(&snap[s].drain_lat,
+                                                 metrics_pct[i]));
+    }
+    metrics_sample(out, "drain_latency_ticks", "_sum", sensor[s], NULL,
+                   snap[s].lat_sum);
+    metrics_sample(out, "drain_latency_ticks", "_count", sensor[s], NULL,
+                   snap[s].drain_lat.count);
+  }
+}
+
+static void metrics_json(metrics_out_t *out,
+                         const iis3dwb_metrics_data_t *snap,
+                         const char *const *sensor, uint8_t num,
+                         uint32_t tick_hz)
+{
+  uint64_t cum;
+  uint8_t i;
+  uint8_t k;
+  uint8_t s;
+
+  metrics_puts(out, "[");
+  for (s = 0U; s < num; s++)
+  {
+    metrics_puts(out, (s == 0U) ? "{\"sensor\":\"" : ",{\"sensor\":\"");
+    metrics_puts(out, sensor[s]);
+    metrics_puts(out, "\"");
+
+    for (k = 0U; k < METRICS_COUNTERS; k++)
+    {
+      metrics_member(out, metrics_name[k], metrics_counter(&snap[s], k));
+    }
+    metrics_member(out, "fifo_bytes_per_second",
+                   metrics_rate(&snap[s], tick_hz));
+
+    /* same cumulative buckets as the text format, last one le 512 */
+    metrics_puts(out, ",\"fifo_fill_words\":{\"le\":[");
+    for (i = 0U; i < IIS3DWB_METRICS_FILL_BUCKETS; i++)
+    {
+      metrics_puts(out, (i == 0U) ? "" : ",");
+      metrics_puts(out, metrics_le[i]);
+    }
+    metrics_puts(out, "],\"bucket\":[");
+    cum = 0U;
+    for (i = 0U; i < IIS3DWB_METRICS_FILL_BUCKETS; i++)
+    {
+      cum += snap[s].fill[i];
+      metrics_puts(out, (i == 0U) ? "" : ",");
+      metrics_putu(out, cum);
+    }
+    metrics_puts(out, "]");
+    metrics_member(out, "sum", snap[s].fill_sum);
+    metrics_member(out, "count", cum);
+
+    metrics_puts(out, "},\"drain_latency_ticks\":{\"quantile\":{");
+    for (i = 0U; i < 3U; i++)
+    {
+      metrics_puts(out, (i == 0U) ? "\"" : ",\"");
+      metrics_puts(out, metrics_quantile[i]);
+      metrics_puts(out, "\":");
+      metrics_putu(out, iis3dwb_lat_hist_percentile(&snap[s].drain_lat,
+                                                    metrics_pct[i]));
+    }
+    metrics_puts(out, "}");
+    metrics_member(out, "sum", snap[s].lat_sum);
+    metrics_member(out, "count", snap[s].drain_lat.count);
+    metrics_puts(out, "}}");
+  }
+  metrics_puts(out, "]\n");
+}
+
+/**
+  * @brief  Initialize the metrics of a device.
+  *
+  * @param  m      Device metrics.(ptr)
+  * @param  tick   Host timer used for drain latency and throughput,
+  *                NULL -> not measured.
+  * @retval        0 -> metrics ready, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_metrics_init(iis3dwb_metrics_t *m, iis3dwb_tick_ptr tick)
+{
+  if (m == NULL)
+  {
+    return -1;
+  }
+
+  memset(m, 0, sizeof(iis3dwb_metrics_t));
+  m->tick = tick;
+  iis3dwb_lat_hist_reset(&m->data.drain_lat);
+
+  return 0;
+}
+
+/**
+  * @brief  Record one FIFO drain done by the application.
+  *
+  * @param  m       Device metrics.(ptr)
+  * @param  status  FIFO status read before the data.(ptr)
+  * @param  words   Number of FIFO words read.
+  * @param  start   Host timer at the status read.
+  *
+  */
+void iis3dwb_metrics_update(iis3dwb_metrics_t *m,
+                            const iis3dwb_fifo_status_t *status,
+                            uint16_t words, uint32_t start)
+{
+  iis3dwb_metrics_data_t *d = &m->data;
+  const uint32_t now = (m->tick != NULL) ? m->tick() : start;
+  uint32_t bucket = (uint32_t)status->fifo_level / 32U;
+
+  m->seq++;
+  IIS3DWB_METRICS_BARRIER();
+
+  if (d->drains == 0U)
+  {
+    d->first_tick = start;
+  }
+  d->drains++;
+  d->last_tick = now;
+  d->fifo_ovr += status->fifo_ovr;
+  d->fifo_full += status->fifo_full;
+  d->wtm_hits += status->fifo_th;
+  d->words += words;
+  d->bytes += 7U * (uint32_t)words;
+
+  bucket = (bucket < IIS3DWB_METRICS_FILL_BUCKETS) ? bucket :
+           (IIS3DWB_METRICS_FILL_BUCKETS - 1U);
+  d->fill[bucket]++;
+  d->fill_sum += status->fifo_level;
+
+  if (m->tick != NULL)
+  {
+    iis3dwb_lat_hist_add(&d->drain_lat, now - start);
+    d->lat_sum += now - start;
+  }
+
+  IIS3DWB_METRICS_BARRIER();
+  m->seq++;
+}
+
+/**
+  * @brief  Record the result of decoding drained words, e.g. the samples
+  *         returned by iis3dwb_fifo_dec_run and the words it skipped.
+  *
+  * @param  m        Device metrics.(ptr)
+  * @param  samples  Accelerometer samples decoded.
+  * @param  errors   Words that could not be decoded.
+  *
+  */
+void iis3dwb_metrics_decode_add(iis3dwb_metrics_t *m, uint16_t samples,
+                                uint16_t errors)
+{
+  m->seq++;
+  IIS3DWB_METRICS_BARRIER();
+
+  m->data.samples += samples;
+  m->data.decode_err += errors;
+
+  IIS3DWB_METRICS_BARRIER();
+  m->seq++;
+}
+
+/**
+  * @brief  Drain up to max FIFO words and record the drain.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  m      Device metrics.(ptr)
+  * @param  fdata  Buffer of max FIFO words.(ptr)
+  * @param  max    Buffer length in FIFO words.
+  * @param  num    FIFO words read.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_metrics_fifo_drain(const stmdev_ctx_t *ctx,
+                                   iis3dwb_metrics_t *m,
+                                   iis3dwb_fifo_out_raw_t *fdata,
+                                   uint16_t max, uint16_t *num)
+{
+  iis3dwb_fifo_status_t status = {0};
+  const uint32_t start = (m->tick != NULL) ? m->tick() : 0U;
+  uint16_t len;
+  int32_t ret;
+
+  *num = 0U;
+
+  ret = iis3dwb_fifo_status_get(ctx, &status);
+  len = (status.fifo_level > max) ? max : status.fifo_level;
+
+  if ((ret == 0) && (len > 0U))
+  {
+    ret = iis3dwb_fifo_out_multi_raw_get(ctx, fdata, len);
+  }
+
+  if (ret == 0)
+  {
+    *num = len;
+    iis3dwb_metrics_update(m, &status, len, start);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Take a consistent copy of the metrics, from any context.
+  *
+  * @param  m      Device metrics.(ptr)
+  * @param  snap   Copy of the metrics.(ptr)
+  * @retval        0 -> consistent copy, -1 -> update in progress
+  *                (e.g. snapshot from an interrupt preempting the
+  *                writer), retry later.
+  *
+  */
+int32_t iis3dwb_metrics_snapshot(const iis3dwb_metrics_t *m,
+                                 iis3dwb_metrics_data_t *snap)
+{
+  uint32_t seq;
+  uint8_t i;
+
+  for (i = 0U; i < METRICS_SNAP_TRIES; i++)
+  {
+    seq = m->seq;
+    IIS3DWB_METRICS_BARRIER();
+    memcpy(snap, &m->data, sizeof(iis3dwb_metrics_data_t));
+    IIS3DWB_METRICS_BARRIER();
+
+    if (((seq & 1U) == 0U) && (seq == m->seq))
+    {
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+/**
+  * @brief  Write the metrics snapshots of one or more devices, without
+  *         stdio. The text exposition format groups each metric family
+  *         under one TYPE line: counters, throughput gauge, FIFO fill
+  *         histogram and drain latency summary. The JSON format is an
+  *         array with the same values, one object per device. The
+  *         output is handed to the writer in chunks of up to 64
+  *         characters.
+  *
+  * @param  snap     Metrics snapshots, num elements.(ptr)
+  * @param  sensor   Device names, used as label / "sensor" field.(ptr)
+  * @param  num      Number of devices.
+  * @param  tick_hz  Host timer frequency, 0 -> no throughput.
+  * @param  fmt      IIS3DWB_METRICS_TEXT, IIS3DWB_METRICS_JSON.
+  * @param  write    Writer, e.g. appending to a file.(ptr)
+  * @param  arg      Writer argument.(ptr)
+  * @retval          0 -> written, otherwise first writer error.
+  *
+  */
+int32_t iis3dwb_metrics_export(const iis3dwb_metrics_data_t *snap,
+                               const char *const *sensor, uint8_t num,
+                               uint32_t tick_hz, iis3dwb_metrics_fmt_t fmt,
+                               iis3dwb_metrics_write_t write, void *arg)
+{
+  metrics_out_t out;
+
+  out.write = write;
+  out.arg = arg;
+  out.len = 0U;
+  out.ret = 0;
+
+  if (fmt == IIS3DWB_METRICS_JSON)
+  {
+    metrics_json(&out, snap, sensor, num, tick_hz);
+  }
+  else
+  {
+    metrics_text(&out, snap, sensor, num, tick_hz);
+  }
+
+  metrics_flush(&out);
+
+  return out.ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_budget Throughput Budget
+  * @brief      This section groups the functions that estimate how many
+  *             devices one core and bus can drain, decode and convert
+  *             at full rate for a given watermark, read chunk and
+  *             batching configuration.
+  *             Devices are drained one after the other: each drain is a
+  *             FIFO status read followed by the data reads, then the
+  *             decoding of the words read.
+  * @{
+  *
+  */
+
+#define BUDGET_XL_WORDS_S     26667U
+#define BUDGET_TEMP_WORDS_S   104U
+#define BUDGET_FIFO_WORDS     512U
+#define BUDGET_COLUMNS        18U
+
+/**
+  * @brief  Measure on the target the CPU time to decode and convert
+  *         FIFO words, as cpu_ns_word of the budget configuration.
+  *         Use a buffer of real FIFO words (e.g. one drain) read with
+  *         the batching configuration being evaluated.
+  *
+  * @param  tick     Host timer.(ptr)
+  * @param  tick_hz  Host timer frequency.
+  * @param  dec      Decoder initialized for the configuration.(ptr)
+  * @param  fdata    FIFO words.(ptr)
+  * @param  num      Number of FIFO words.
+  * @param  fs       Accelerometer full scale.
+  * @param  xl       Buffer of 3 * num raw elements.(ptr)
+  * @param  mg       Buffer of 3 * num converted elements.(ptr)
+  * @param  val      CPU time per FIFO word (ns), rounded up.(ptr)
+  * @retval          0 -> measured, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_budget_cpu_measure(iis3dwb_tick_ptr tick, uint32_t tick_hz,
+                                   iis3dwb_fifo_dec_t *dec,
+                                   const iis3dwb_fifo_out_raw_t *fdata,
+                                   uint16_t num, iis3dwb_fs_xl_t fs,
+                                   int16_t *xl, float_t *mg, uint32_t *val)
+{
+  uint64_t ns;
+  uint32_t start;
+  uint32_t ticks;
+  uint16_t cnt;
+
+  if ((tick == NULL) || (tick_hz == 0U) || (dec == NULL) ||
+      (fdata == NULL) || (num == 0U) || (xl == NULL) || (mg == NULL) ||
+      (val == NULL))
+  {
+    return -1;
+  }
+
+  start = tick();
+  cnt = iis3dwb_fifo_dec_run(dec, fdata, num, xl, NULL);
+  iis3dwb_xl_block_to_mg(fs, xl,
+                         (uint32_t)cnt * iis3dwb_fifo_dec_stride(dec), mg);
+  ticks = tick() - start;
+
+  ns = (((uint64_t)ticks * 1000000000U) + tick_hz - 1U) / tick_hz;
+  *val = (uint32_t)((ns + num - 1U) / num);
+
+  return 0;
+}
+
+/**
+  * @brief  Estimate the drain budget of a configuration.
+  *
+  * @param  cfg    Bus, CPU cost and FIFO configuration; cpu_ns_word is
+  *                measured on the target with
+  *                iis3dwb_budget_cpu_measure.(ptr)
+  * @param  val    Estimated budget.(ptr)
+  * @retval        0 -> estimate done, -1 -> invalid configuration.
+  *
+  */
+int32_t iis3dwb_budget_get(const iis3dwb_budget_cfg_t *cfg,
+                           iis3dwb_budget_t *val)
+{
+  uint64_t byte_ns;
+  uint64_t drain_ns;
+  uint64_t n_load;
+  uint64_t n_level;
+  uint32_t xl_wps;
+  uint32_t xact;
+
+  if ((cfg == NULL) || (val == NULL))
+  {
+    return -1;
+  }
+
+  if ((cfg->bus_hz == 0U) || (cfg->bits_per_byte == 0U) ||
+      (cfg->wtm == 0U) || (cfg->wtm >= BUDGET_FIFO_WORDS) ||
+      (cfg->chunk == 0U))
+  {
+    return -1;
+  }
+
+  /* the ALL_OUT_REG selections pack three samples of one axis in each
+   * FIFO word, the others batch one sample (one or three axes) a word
+   */
+  xl_wps = (((uint8_t)cfg->axis_sel & 0x10U) != 0U) ?
+           ((BUDGET_XL_WORDS_S + 2U) / 3U) : BUDGET_XL_WORDS_S;
+  val->words_per_s = xl_wps;
+
+  switch (cfg->ts_batch)
+  {
+    case IIS3DWB_DEC_1:
+      val->words_per_s += xl_wps;
+      break;
+
+    case IIS3DWB_DEC_8:
+      val->words_per_s += (xl_wps + 7U) / 8U;
+      break;
+
+    case IIS3DWB_DEC_32:
+      val->words_per_s += (xl_wps + 31U) / 32U;
+      break;
+
+    case IIS3DWB_NO_DECIMATION:
+    default:
+      break;
+  }
+
+  if (cfg->temp_batch == IIS3DWB_TEMP_BATCHED_AT_104Hz)
+  {
+    val->words_per_s += BUDGET_TEMP_WORDS_S;
+  }
+
+  val->period_ns = (uint32_t)(((uint64_t)cfg->wtm * 1000000000U) /
+                              val->words_per_s);
+
+  /* status: address + FIFO_STATUS1/2, data: address + 7 bytes a word */
+  xact = ((uint32_t)cfg->wtm + cfg->chunk - 1U) / cfg->chunk;
+  byte_ns = ((uint64_t)cfg->bits_per_byte * 1000000000U) / cfg->bus_hz;
+  val->bus_ns = (uint32_t)((((uint64_t)xact + 1U) * cfg->xact_ns) +
+                           ((3U + xact + (7U * (uint64_t)cfg->wtm)) *
+                            byte_ns));
+  val->cpu_ns = (uint32_t)((uint64_t)cfg->wtm * cfg->cpu_ns_word);
+  drain_ns = (uint64_t)val->bus_ns + val->cpu_ns;
+
+  /* a device waits for all the others before being drained again */
+  val->load_pm = (uint32_t)((drain_ns * cfg->sensors * 1000U) /
+                            val->period_ns);
+  val->peak_level = cfg->wtm + (uint32_t)(((drain_ns * cfg->sensors *
+                                            val->words_per_s) +
+                                           999999999U) / 1000000000U);
+
+  n_load = val->period_ns / ((drain_ns == 0U) ? 1U : drain_ns);
+  n_level = (((uint64_t)BUDGET_FIFO_WORDS - cfg->wtm) * 1000000000U) /
+            ((drain_ns == 0U) ? 1U : (drain_ns * val->words_per_s));
+  n_load = (n_level < n_load) ? n_level : n_load;
+  val->max_sensors = (n_load > 0xFFFFU) ? 0xFFFFU : (uint16_t)n_load;
+  val->overrun = ((val->load_pm > 1000U) ||
+                  (val->peak_level > BUDGET_FIFO_WORDS)) ? 1U : 0U;
+
+  return 0;
+}
+
+/**
+  * @brief  Write a configuration and its budget as a CSV row, for
+  *         sweeps over watermark, chunk, batching and device count.
+  *
+  * @param  cfg     Configuration.(ptr)
+  * @param  val     Budget of the configuration.(ptr)
+  * @param  header  1 -> write the column names first.
+  * @param  write   Writer, e.g. appending to a file.(ptr)
+  * @param  arg     Writer argument.(ptr)
+  * @retval         0 -> written, otherwise first writer error.
+  *
+  */
+int32_t iis3dwb_budget_export(const iis3dwb_budget_cfg_t *cfg,
+                              const iis3dwb_budget_t *val, uint8_t header,
+                              iis3dwb_metrics_write_t write, void *arg)
+{
+  uint64_t col[BUDGET_COLUMNS];
+  metrics_out_t out;
+  uint8_t i;
+
+  if ((cfg == NULL) || (val == NULL) || (write == NULL))
+  {
+    return -1;
+  }
+
+  col[0] = cfg->sensors;
+  col[1] = cfg->wtm;
+  col[2] = cfg->chunk;
+  col[3] = (uint64_t)cfg->axis_sel;
+  col[4] = (uint64_t)cfg->ts_batch;
+  col[5] = (uint64_t)cfg->temp_batch;
+  col[6] = cfg->bus_hz;
+  col[7] = cfg->bits_per_byte;
+  col[8] = cfg->xact_ns;
+  col[9] = cfg->cpu_ns_word;
+  col[10] = val->words_per_s;
+  col[11] = val->period_ns;
+  col[12] = val->bus_ns;
+  col[13] = val->cpu_ns;
+  col[14] = val->load_pm;
+  col[15] = val->peak_level;
+  col[16] = val->max_sensors;
+  col[17] = val->overrun;
+
+  out.write = write;
+  out.arg = arg;
+  out.len = 0U;
+  out.ret = 0;
+
+  if (header != 0U)
+  {
+    metrics_puts(&out, "sensors,wtm,chunk,axis_sel,ts_batch,temp_batch,"
+                 "bus_hz,bits_per_byte,xact_ns,cpu_ns_word,words_per_s,"
+                 "period_ns,bus_ns,cpu_ns,load_pm,peak_level,max_sensors,"
+                 "overrun\n");
+  }
+
+  for (i = 0U; i < BUDGET_COLUMNS; i++)
+  {
+    metrics_puts(&out, (i == 0U) ? "" : ",");
+    metrics_putu(&out, col[i]);
+  }
+  metrics_puts(&out, "\n");
+  metrics_flush(&out);
+
+  return out.ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @}
+  *
+  */
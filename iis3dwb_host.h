@@ -0,0 +1,139 @@
+/**
+  ******************************************************************************
+  * @file    iis3dwb_host.h
+  * @author  Sensors Software Solution Team
+  * @brief   This file contains all the functions prototypes for the
+  *          iis3dwb_host.c optional host-side module.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef IIS3DWB_HOST_H
+#define IIS3DWB_HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "iis3dwb_reg.h"
+
+/** @addtogroup IIS3DWB_HOST
+  * @{
+  *
+  */
+
+/* Memory barrier around the updates of the metrics sequence counter */
+#ifndef IIS3DWB_METRICS_BARRIER
+#define IIS3DWB_METRICS_BARRIER()            IIS3DWB_RING_BARRIER()
+#endif /* IIS3DWB_METRICS_BARRIER */
+
+#define IIS3DWB_METRICS_FILL_BUCKETS         16U   /* 32 FIFO words each */
+
+typedef struct
+{
+  uint32_t drains;          /* FIFO drains recorded */
+  uint32_t fifo_ovr;        /* drains that found the FIFO overrun */
+  uint32_t fifo_full;       /* drains that found the FIFO full */
+  uint32_t wtm_hits;        /* drains that found the watermark reached */
+  uint32_t words;           /* FIFO words read */
+  uint32_t samples;         /* accelerometer samples decoded */
+  uint32_t decode_err;      /* words the decoder could not use */
+  uint64_t bytes;           /* bytes read from the FIFO */
+  uint32_t fill[IIS3DWB_METRICS_FILL_BUCKETS];  /* FIFO level at drain */
+  uint64_t fill_sum;        /* sum of the FIFO levels at drain */
+  iis3dwb_lat_hist_t drain_lat;  /* status read to end of data read */
+  uint64_t lat_sum;         /* sum of the drain latencies */
+  uint32_t first_tick;      /* first and last drain, host timer ticks */
+  uint32_t last_tick;
+} iis3dwb_metrics_data_t;
+
+typedef struct
+{
+  volatile uint32_t seq;    /* odd while the data is being updated */
+  iis3dwb_tick_ptr tick;    /* free running timer of the host */
+  iis3dwb_metrics_data_t data;
+} iis3dwb_metrics_t;
+
+typedef enum
+{
+  IIS3DWB_METRICS_TEXT = 0,   /* text exposition format */
+  IIS3DWB_METRICS_JSON = 1,
+} iis3dwb_metrics_fmt_t;
+
+typedef int32_t (*iis3dwb_metrics_write_t)(void *arg, const char *buf,
+                                           uint16_t len);
+
+int32_t iis3dwb_metrics_init(iis3dwb_metrics_t *m, iis3dwb_tick_ptr tick);
+void iis3dwb_metrics_update(iis3dwb_metrics_t *m,
+                            const iis3dwb_fifo_status_t *status,
+                            uint16_t words, uint32_t start);
+void iis3dwb_metrics_decode_add(iis3dwb_metrics_t *m, uint16_t samples,
+                                uint16_t errors);
+int32_t iis3dwb_metrics_fifo_drain(const stmdev_ctx_t *ctx,
+                                   iis3dwb_metrics_t *m,
+                                   iis3dwb_fifo_out_raw_t *fdata,
+                                   uint16_t max, uint16_t *num);
+int32_t iis3dwb_metrics_snapshot(const iis3dwb_metrics_t *m,
+                                 iis3dwb_metrics_data_t *snap);
+int32_t iis3dwb_metrics_export(const iis3dwb_metrics_data_t *snap,
+                               const char *const *sensor, uint8_t num,
+                               uint32_t tick_hz, iis3dwb_metrics_fmt_t fmt,
+                               iis3dwb_metrics_write_t write, void *arg);
+
+typedef struct
+{
+  uint32_t bus_hz;          /* SPI clock or I2C bit rate */
+  uint8_t bits_per_byte;    /* 8 for SPI, 9 for I2C (ACK bit) */
+  uint32_t xact_ns;         /* fixed cost of one bus transaction */
+  uint32_t cpu_ns_word;     /* measured decode + conversion per word */
+  uint16_t wtm;             /* FIFO watermark (words per drain) */
+  uint16_t chunk;           /* FIFO words per read transaction */
+  iis3dwb_xl_axis_sel_t axis_sel;
+  iis3dwb_fifo_timestamp_batch_t ts_batch;
+  iis3dwb_odr_t_batch_t temp_batch;
+  uint16_t sensors;         /* devices drained by the same core / bus */
+} iis3dwb_budget_cfg_t;
+
+typedef struct
+{
+  uint32_t words_per_s;     /* FIFO words per second of one device */
+  uint32_t period_ns;       /* time to reach the watermark */
+  uint32_t bus_ns;          /* bus time of one drain */
+  uint32_t cpu_ns;          /* CPU time of one drain */
+  uint32_t load_pm;         /* core / bus load of all devices (1/1000) */
+  uint32_t peak_level;      /* worst FIFO level before being drained */
+  uint16_t max_sensors;     /* devices sustainable without overrun */
+  uint8_t overrun;          /* 1 -> configuration overruns */
+} iis3dwb_budget_t;
+int32_t iis3dwb_budget_cpu_measure(iis3dwb_tick_ptr tick, uint32_t tick_hz,
+                                   iis3dwb_fifo_dec_t *dec,
+                                   const iis3dwb_fifo_out_raw_t *fdata,
+                                   uint16_t num, iis3dwb_fs_xl_t fs,
+                                   int16_t *xl, float_t *mg, uint32_t *val);
+int32_t iis3dwb_budget_get(const iis3dwb_budget_cfg_t *cfg,
+                           iis3dwb_budget_t *val);
+int32_t iis3dwb_budget_export(const iis3dwb_budget_cfg_t *cfg,
+                              const iis3dwb_budget_t *val, uint8_t header,
+                              iis3dwb_metrics_write_t write, void *arg);
+
+/**
+  *@}
+  *
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IIS3DWB_HOST_H */
@@ -80,6 +80,39 @@ int32_t __weak iis3dwb_write_reg(const stmdev_ctx_t *ctx, uint8_t reg,
   return ctx->write_reg(ctx->handle, reg, data, len);
 }
 
+/**
+  * @brief  Update the fields selected by mask in a generic device register
+  *         with a single read and at most a single write. The write is
+  *         skipped when the register already holds the requested value.
+  *
+  * @param  ctx   read / write interface definitions(ptr)
+  * @param  reg   register to update
+  * @param  mask  fields to update (OR of IIS3DWB_<REG>_<FIELD>_MSK)
+  * @param  val   new fields value (OR of IIS3DWB_FIELD_PREP)
+  * @retval       interface status (MANDATORY: return 0 -> no Error)
+  *
+  */
+int32_t iis3dwb_reg_bits_set(const stmdev_ctx_t *ctx, uint8_t reg,
+                             uint8_t mask, uint8_t val)
+{
+  uint8_t data = 0;
+  uint8_t upd;
+
+  int32_t ret = iis3dwb_read_reg(ctx, reg, &data, 1);
+
+  if (ret == 0)
+  {
+    upd = (uint8_t)((data & (uint8_t)~mask) | (val & mask));
+
+    if (upd != data)
+    {
+      ret = iis3dwb_write_reg(ctx, reg, &upd, 1);
+    }
+  }
+
+  return ret;
+}
+
 /**
   * @}
   *
@@ -1053,6 +1086,41 @@ int32_t iis3dwb_fifo_sensor_tag_get(const stmdev_ctx_t *ctx,
   return ret;
 }
 
+/**
+  * @brief  Decode the accelerometer samples of a FIFO data buffer,
+  *         skipping the words with a different tag.
+  *
+  * @param  fdata  FIFO words read by iis3dwb_fifo_out_multi_raw_get.(ptr)
+  * @param  num    Number of FIFO words.
+  * @param  xl     Buffer that stores X, Y, Z of each sample (3 * num).
+  * @retval        Number of accelerometer samples decoded.
+  *
+  */
+uint16_t iis3dwb_fifo_xl_decode(const iis3dwb_fifo_out_raw_t *fdata,
+                                uint16_t num, int16_t *xl)
+{
+  uint16_t cnt = 0U;
+  uint16_t i;
+  uint8_t j;
+
+  for (i = 0U; i < num; i++)
+  {
+    if (IIS3DWB_FIELD_GET(IIS3DWB_FIFO_DATA_OUT_TAG_TAG_SENSOR,
+                          fdata[i].tag) == (uint8_t)IIS3DWB_XL_TAG)
+    {
+      for (j = 0U; j < 3U; j++)
+      {
+        xl[(3U * cnt) + j] = (int16_t)fdata[i].data[(2U * j) + 1U];
+        xl[(3U * cnt) + j] = (xl[(3U * cnt) + j] * 256) +
+                             (int16_t)fdata[i].data[2U * j];
+      }
+      cnt++;
+    }
+  }
+
+  return cnt;
+}
+
 /**
   * @}
   *
@@ -1118,6 +1186,30 @@ int32_t iis3dwb_odr_cal_reg_get(const stmdev_ctx_t *ctx, uint8_t *val)
   return ret;
 }
 
+/**
+  * @brief  Effective accelerometer ODR, i.e. the typical 26667 Hz
+  *         corrected by INTERNAL_FREQ_FINE (0.15% per LSB).
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  val    Effective ODR (Hz).(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_xl_odr_actual_get(const stmdev_ctx_t *ctx, float_t *val)
+{
+  uint8_t freq_fine = 0U;
+  int32_t ret;
+
+  ret = iis3dwb_odr_cal_reg_get(ctx, &freq_fine);
+
+  if (ret == 0)
+  {
+    *val = 26667.0f * (1.0f + (0.0015f * (float_t)(int8_t)freq_fine));
+  }
+
+  return ret;
+}
+
 /**
   * @brief  Data-ready pulsed / letched mode.[set]
   *
@@ -3177,7 +3269,7 @@ int32_t iis3dwb_rst_batch_counter_get(const stmdev_ctx_t *ctx, uint8_t *val)
 int32_t iis3dwb_batch_counter_threshold_set(const stmdev_ctx_t *ctx,
                                             uint16_t val)
 {
-  iis3dwb_counter_bdr_reg2_t counter_bdr_reg1 = {0};
+  iis3dwb_counter_bdr_reg1_t counter_bdr_reg1 = {0};
   iis3dwb_counter_bdr_reg2_t counter_bdr_reg2 = {0};
 
   int32_t ret = iis3dwb_read_reg(ctx, IIS3DWB_COUNTER_BDR_REG1,
@@ -3304,3 +3396,2794 @@ int32_t iis3dwb_fifo_status_get(const stmdev_ctx_t *ctx,
   * @}
   *
   */
+
+/**
+  * @defgroup   IIS3DWB_cfg_image Configuration Image
+  * @brief      This section groups the functions that translate a whole
+  *             device configuration into a register image and write it
+  *             with a few burst transactions.
+  * @{
+  *
+  */
+
+/* Writable register runs of the image, CTRL1_XL last to start the sensor
+ * only when the rest of the configuration is in place.
+ */
+static const uint8_t cfg_img_runs[][2] =
+{
+  { IIS3DWB_PIN_CTRL,      1U },
+  { IIS3DWB_FIFO_CTRL1,    8U },
+  { IIS3DWB_CTRL3_C,       6U },
+  { IIS3DWB_CTRL10_C,      1U },
+  { IIS3DWB_SLOPE_EN,      1U },
+  { IIS3DWB_INTERRUPTS_EN, 1U },
+  { IIS3DWB_WAKE_UP_THS,   2U },
+  { IIS3DWB_MD1_CFG,       2U },
+  { IIS3DWB_X_OFS_USR,     3U },
+  { IIS3DWB_CTRL1_XL,      1U },
+};
+
+static const uint8_t *cfg_img_ptr(const iis3dwb_cfg_img_t *img, uint8_t reg)
+{
+  const uint8_t *ptr;
+
+  if (reg >= IIS3DWB_X_OFS_USR)
+  {
+    ptr = &img->ofs_usr[reg - IIS3DWB_X_OFS_USR];
+  }
+  else if (reg >= IIS3DWB_SLOPE_EN)
+  {
+    ptr = &img->md[reg - IIS3DWB_SLOPE_EN];
+  }
+  else
+  {
+    ptr = &img->ctrl[reg - IIS3DWB_PIN_CTRL];
+  }
+
+  return ptr;
+}
+
+static int32_t cfg_check(const iis3dwb_cfg_t *cfg)
+{
+  uint8_t sleep_change;
+  uint8_t sleep_status;
+  uint8_t i;
+
+  if ((cfg->fifo_wtm > 0x01FFU) || (cfg->cnt_bdr_th > 0x07FFU) ||
+      (cfg->wkup_ths > 0x3FU) || (cfg->wkup_dur > 0x03U) ||
+      (cfg->sleep_dur > 0x0FU))
+  {
+    return -1;
+  }
+
+  for (i = 0U; i < 3U; i++)
+  {
+    if (cfg->usr_offset[i] < -127)
+    {
+      return -1;
+    }
+  }
+
+  /* drdy_temp and timestamp exist only on INT2, boot only on INT1 */
+  if ((cfg->int1_route.drdy_temp != 0U) || (cfg->int1_route.timestamp != 0U) ||
+      (cfg->int2_route.boot != 0U))
+  {
+    return -1;
+  }
+
+  /* sleep_status_on_int is shared by both pins */
+  sleep_change = cfg->int1_route.sleep_change | cfg->int2_route.sleep_change;
+  sleep_status = cfg->int1_route.sleep_status | cfg->int2_route.sleep_status;
+  if ((sleep_change != 0U) && (sleep_status != 0U))
+  {
+    return -1;
+  }
+
+  if ((cfg->fifo_mode != IIS3DWB_BYPASS_MODE) &&
+      (cfg->fifo_xl_batch == IIS3DWB_XL_NOT_BATCHED) &&
+      (cfg->fifo_temp_batch == IIS3DWB_TEMP_NOT_BATCHED) &&
+      (cfg->fifo_ts_batch == IIS3DWB_NO_DECIMATION))
+  {
+    return -1;
+  }
+
+  if (((cfg->int1_route.fifo_bdr | cfg->int2_route.fifo_bdr) != 0U) &&
+      ((cfg->cnt_bdr_th == 0U) ||
+       (cfg->fifo_xl_batch == IIS3DWB_XL_NOT_BATCHED)))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Translate a device configuration into its register image.
+  *         No bus access is performed, so the image of a fixed
+  *         configuration can be built once and kept as constant data.
+  *
+  * @param  cfg    Device configuration.(ptr)
+  * @param  img    Register image.(ptr)
+  * @retval        0 -> image built, -1 -> illegal configuration.
+  *
+  */
+int32_t iis3dwb_cfg_img_build(const iis3dwb_cfg_t *cfg,
+                              iis3dwb_cfg_img_t *img)
+{
+  iis3dwb_pin_ctrl_t          pin_ctrl = {0};
+  iis3dwb_fifo_ctrl1_t        fifo_ctrl1 = {0};
+  iis3dwb_fifo_ctrl2_t        fifo_ctrl2 = {0};
+  iis3dwb_fifo_ctrl3_t        fifo_ctrl3 = {0};
+  iis3dwb_fifo_ctrl4_t        fifo_ctrl4 = {0};
+  iis3dwb_counter_bdr_reg1_t  counter_bdr_reg1 = {0};
+  iis3dwb_counter_bdr_reg2_t  counter_bdr_reg2 = {0};
+  iis3dwb_int1_ctrl_t         int1_ctrl = {0};
+  iis3dwb_int2_ctrl_t         int2_ctrl = {0};
+  iis3dwb_ctrl1_xl_t          ctrl1_xl = {0};
+  iis3dwb_ctrl3_c_t           ctrl3_c = {0};
+  iis3dwb_ctrl4_c_t           ctrl4_c = {0};
+  iis3dwb_ctrl5_c_t           ctrl5_c = {0};
+  iis3dwb_ctrl6_c_t           ctrl6_c = {0};
+  iis3dwb_ctrl7_c_t           ctrl7_c = {0};
+  iis3dwb_ctrl8_xl_t          ctrl8_xl = {0};
+  iis3dwb_ctrl10_c_t          ctrl10_c = {0};
+  iis3dwb_slope_en_t          slope_en = {0};
+  iis3dwb_interrupts_en_t     interrupts_en = {0};
+  iis3dwb_wake_up_ths_t       wake_up_ths = {0};
+  iis3dwb_wake_up_dur_t       wake_up_dur = {0};
+  iis3dwb_md1_cfg_t           md1_cfg = {0};
+  iis3dwb_md2_cfg_t           md2_cfg = {0};
+  uint8_t i;
+
+  if ((cfg == NULL) || (img == NULL) || (cfg_check(cfg) != 0))
+  {
+    return -1;
+  }
+
+  memset(img, 0, sizeof(iis3dwb_cfg_img_t));
+
+  /* PIN_CTRL bits 0..5 must be kept at their default value */
+  pin_ctrl.not_used_01 = 0x3FU;
+  pin_ctrl.sdo_pu_en = (uint8_t)cfg->sdo_pu_en;
+
+  fifo_ctrl1.wtm = (uint8_t)(0x00FFU & cfg->fifo_wtm);
+  fifo_ctrl2.wtm = (uint8_t)((0x0100U & cfg->fifo_wtm) >> 8);
+  fifo_ctrl2.stop_on_wtm = cfg->fifo_stop_on_wtm;
+  fifo_ctrl3.bdr_xl = (uint8_t)cfg->fifo_xl_batch;
+  fifo_ctrl4.fifo_mode = (uint8_t)cfg->fifo_mode;
+  fifo_ctrl4.odr_t_batch = (uint8_t)cfg->fifo_temp_batch;
+  fifo_ctrl4.odr_ts_batch = (uint8_t)cfg->fifo_ts_batch;
+
+  counter_bdr_reg1.cnt_bdr_th = (uint8_t)((0x0700U & cfg->cnt_bdr_th) >> 8);
+  counter_bdr_reg1.dataready_pulsed = (uint8_t)cfg->drdy_pulsed;
+  counter_bdr_reg2.cnt_bdr_th = (uint8_t)(0x00FFU & cfg->cnt_bdr_th);
+
+  int1_ctrl.int1_drdy_xl       = cfg->int1_route.drdy_xl;
+  int1_ctrl.int1_boot          = cfg->int1_route.boot;
+  int1_ctrl.int1_fifo_th       = cfg->int1_route.fifo_th;
+  int1_ctrl.int1_fifo_ovr      = cfg->int1_route.fifo_ovr;
+  int1_ctrl.int1_fifo_full     = cfg->int1_route.fifo_full;
+  int1_ctrl.int1_cnt_bdr       = cfg->int1_route.fifo_bdr;
+
+  int2_ctrl.int2_drdy_xl       = cfg->int2_route.drdy_xl;
+  int2_ctrl.int2_drdy_temp     = cfg->int2_route.drdy_temp;
+  int2_ctrl.int2_fifo_th       = cfg->int2_route.fifo_th;
+  int2_ctrl.int2_fifo_ovr      = cfg->int2_route.fifo_ovr;
+  int2_ctrl.int2_fifo_full     = cfg->int2_route.fifo_full;
+  int2_ctrl.int2_cnt_bdr       = cfg->int2_route.fifo_bdr;
+
+  ctrl1_xl.xl_en = (uint8_t)cfg->odr_xl;
+  ctrl1_xl.fs_xl = (uint8_t)cfg->fs_xl;
+  ctrl1_xl.lpf2_xl_en = ((uint8_t)cfg->filt_xl & 0x80U) >> 7;
+
+  /* auto-increment is required by the burst transactions */
+  ctrl3_c.if_inc = PROPERTY_ENABLE;
+  ctrl3_c.bdu = cfg->bdu;
+  ctrl3_c.sim = (uint8_t)cfg->sim;
+  ctrl3_c.pp_od = (uint8_t)cfg->pp_od;
+  ctrl3_c.h_lactive = (uint8_t)cfg->h_lactive;
+
+  ctrl4_c._1ax_to_3regout = ((uint8_t)cfg->axis_sel & 0x10U) >> 4;
+  ctrl4_c.i2c_disable = (uint8_t)cfg->i2c_disable;
+  ctrl4_c.drdy_mask = cfg->drdy_mask;
+  ctrl4_c.int2_on_int1 = cfg->all_on_int1;
+
+  ctrl5_c.rounding = (uint8_t)cfg->rounding;
+
+  ctrl6_c.xl_axis_sel = (uint8_t)cfg->axis_sel & 0x03U;
+  ctrl6_c.usr_off_w = (uint8_t)cfg->usr_off_w;
+
+  ctrl7_c.usr_off_on_out = cfg->usr_off_on_out;
+
+  ctrl8_xl.fds = ((uint8_t)cfg->filt_xl & 0x10U) >> 4;
+  ctrl8_xl.hp_ref_mode_xl = ((uint8_t)cfg->filt_xl & 0x20U) >> 5;
+  ctrl8_xl.hpcf_xl = (uint8_t)cfg->filt_xl & 0x07U;
+  ctrl8_xl.fastsettl_mode_xl = cfg->fast_settling;
+
+  ctrl10_c.timestamp_en = cfg->timestamp_en;
+
+  slope_en.lir = (uint8_t)cfg->lir;
+  slope_en.slope_fds = (uint8_t)cfg->hp_path_internal;
+  slope_en.sleep_status_on_int = cfg->int1_route.sleep_status |
+                                 cfg->int2_route.sleep_status;
+
+  if ((cfg->wkup_ths != 0U) ||
+      ((cfg->int1_route.wake_up | cfg->int2_route.wake_up |
+        cfg->int1_route.sleep_change | cfg->int2_route.sleep_change |
+        slope_en.sleep_status_on_int) != 0U))
+  {
+    interrupts_en.interrupts_enable = PROPERTY_ENABLE;
+  }
+
+  wake_up_ths.wk_ths = cfg->wkup_ths;
+  wake_up_ths.usr_off_on_wu = cfg->usr_off_on_wkup;
+
+  wake_up_dur.sleep_dur = cfg->sleep_dur;
+  wake_up_dur.wake_ths_w = (uint8_t)cfg->wkup_ths_w;
+  wake_up_dur.wake_dur = cfg->wkup_dur;
+
+  md1_cfg.int1_wu = cfg->int1_route.wake_up;
+  md1_cfg.int1_sleep_change = cfg->int1_route.sleep_change |
+                              cfg->int1_route.sleep_status;
+
+  md2_cfg.int2_timestamp = cfg->int2_route.timestamp;
+  md2_cfg.int2_wu = cfg->int2_route.wake_up;
+  md2_cfg.int2_sleep_change = cfg->int2_route.sleep_change |
+                              cfg->int2_route.sleep_status;
+
+  bytecpy(&img->ctrl[IIS3DWB_PIN_CTRL - IIS3DWB_PIN_CTRL], (uint8_t *)&pin_ctrl);
+  bytecpy(&img->ctrl[IIS3DWB_FIFO_CTRL1 - IIS3DWB_PIN_CTRL], (uint8_t *)&fifo_ctrl1);
+  bytecpy(&img->ctrl[IIS3DWB_FIFO_CTRL2 - IIS3DWB_PIN_CTRL], (uint8_t *)&fifo_ctrl2);
+  bytecpy(&img->ctrl[IIS3DWB_FIFO_CTRL3 - IIS3DWB_PIN_CTRL], (uint8_t *)&fifo_ctrl3);
+  bytecpy(&img->ctrl[IIS3DWB_FIFO_CTRL4 - IIS3DWB_PIN_CTRL], (uint8_t *)&fifo_ctrl4);
+  bytecpy(&img->ctrl[IIS3DWB_COUNTER_BDR_REG1 - IIS3DWB_PIN_CTRL],
+          (uint8_t *)&counter_bdr_reg1);
+  bytecpy(&img->ctrl[IIS3DWB_COUNTER_BDR_REG2 - IIS3DWB_PIN_CTRL],
+          (uint8_t *)&counter_bdr_reg2);
+  bytecpy(&img->ctrl[IIS3DWB_INT1_CTRL - IIS3DWB_PIN_CTRL], (uint8_t *)&int1_ctrl);
+  bytecpy(&img->ctrl[IIS3DWB_INT2_CTRL - IIS3DWB_PIN_CTRL], (uint8_t *)&int2_ctrl);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL1_XL - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl1_xl);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL3_C - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl3_c);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL4_C - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl4_c);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL5_C - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl5_c);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL6_C - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl6_c);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL7_C - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl7_c);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL8_XL - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl8_xl);
+  bytecpy(&img->ctrl[IIS3DWB_CTRL10_C - IIS3DWB_PIN_CTRL], (uint8_t *)&ctrl10_c);
+  bytecpy(&img->md[IIS3DWB_SLOPE_EN - IIS3DWB_SLOPE_EN], (uint8_t *)&slope_en);
+  bytecpy(&img->md[IIS3DWB_INTERRUPTS_EN - IIS3DWB_SLOPE_EN],
+          (uint8_t *)&interrupts_en);
+  bytecpy(&img->md[IIS3DWB_WAKE_UP_THS - IIS3DWB_SLOPE_EN], (uint8_t *)&wake_up_ths);
+  bytecpy(&img->md[IIS3DWB_WAKE_UP_DUR - IIS3DWB_SLOPE_EN], (uint8_t *)&wake_up_dur);
+  bytecpy(&img->md[IIS3DWB_MD1_CFG - IIS3DWB_SLOPE_EN], (uint8_t *)&md1_cfg);
+  bytecpy(&img->md[IIS3DWB_MD2_CFG - IIS3DWB_SLOPE_EN], (uint8_t *)&md2_cfg);
+
+  for (i = 0U; i < 3U; i++)
+  {
+    img->ofs_usr[i] = (uint8_t)cfg->usr_offset[i];
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Write a register image built by iis3dwb_cfg_img_build.
+  *         Reserved and read-only addresses are skipped, so the image
+  *         is written with ten burst transactions.[set]
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  img    Register image.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_cfg_img_write(const stmdev_ctx_t *ctx,
+                              const iis3dwb_cfg_img_t *img)
+{
+  const uint8_t runs = (uint8_t)(sizeof(cfg_img_runs) / sizeof(cfg_img_runs[0]));
+  uint8_t buff[8];
+  uint8_t i;
+  int32_t ret = 0;
+
+  if (img == NULL)
+  {
+    return -1;
+  }
+
+  for (i = 0U; (ret == 0) && (i < runs); i++)
+  {
+    memcpy(buff, cfg_img_ptr(img, cfg_img_runs[i][0]), cfg_img_runs[i][1]);
+    ret = iis3dwb_write_reg(ctx, cfg_img_runs[i][0], buff, cfg_img_runs[i][1]);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Read the register image with one burst per register block
+  *         (three transactions).[get]
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  img    Register image.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_cfg_img_get(const stmdev_ctx_t *ctx, iis3dwb_cfg_img_t *img)
+{
+  int32_t ret;
+
+  if (img == NULL)
+  {
+    return -1;
+  }
+
+  ret = iis3dwb_read_reg(ctx, IIS3DWB_PIN_CTRL, img->ctrl,
+                         (uint16_t)sizeof(img->ctrl));
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_read_reg(ctx, IIS3DWB_SLOPE_EN, img->md,
+                           (uint16_t)sizeof(img->md));
+  }
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_read_reg(ctx, IIS3DWB_X_OFS_USR, img->ofs_usr,
+                           (uint16_t)sizeof(img->ofs_usr));
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Apply a whole device configuration.[set]
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  val    Device configuration.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_cfg_set(const stmdev_ctx_t *ctx, const iis3dwb_cfg_t *val)
+{
+  iis3dwb_cfg_img_t img;
+
+  int32_t ret = iis3dwb_cfg_img_build(val, &img);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_cfg_img_write(ctx, &img);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Translate a register image back into a device configuration.
+  *         No bus access is performed.
+  *
+  * @param  img    Register image.(ptr)
+  * @param  cfg    Device configuration.(ptr)
+  * @retval        0 -> image decoded, -1 -> NULL pointer.
+  *
+  */
+int32_t iis3dwb_cfg_img_decode(const iis3dwb_cfg_img_t *img,
+                               iis3dwb_cfg_t *cfg)
+{
+  iis3dwb_pin_ctrl_t          pin_ctrl;
+  iis3dwb_fifo_ctrl1_t        fifo_ctrl1;
+  iis3dwb_fifo_ctrl2_t        fifo_ctrl2;
+  iis3dwb_fifo_ctrl3_t        fifo_ctrl3;
+  iis3dwb_fifo_ctrl4_t        fifo_ctrl4;
+  iis3dwb_counter_bdr_reg1_t  counter_bdr_reg1;
+  iis3dwb_counter_bdr_reg2_t  counter_bdr_reg2;
+  iis3dwb_int1_ctrl_t         int1_ctrl;
+  iis3dwb_int2_ctrl_t         int2_ctrl;
+  iis3dwb_ctrl1_xl_t          ctrl1_xl;
+  iis3dwb_ctrl3_c_t           ctrl3_c;
+  iis3dwb_ctrl4_c_t           ctrl4_c;
+  iis3dwb_ctrl5_c_t           ctrl5_c;
+  iis3dwb_ctrl6_c_t           ctrl6_c;
+  iis3dwb_ctrl7_c_t           ctrl7_c;
+  iis3dwb_ctrl8_xl_t          ctrl8_xl;
+  iis3dwb_ctrl10_c_t          ctrl10_c;
+  iis3dwb_slope_en_t          slope_en;
+  iis3dwb_wake_up_ths_t       wake_up_ths;
+  iis3dwb_wake_up_dur_t       wake_up_dur;
+  iis3dwb_md1_cfg_t           md1_cfg;
+  iis3dwb_md2_cfg_t           md2_cfg;
+  uint8_t i;
+
+  if ((img == NULL) || (cfg == NULL))
+  {
+    return -1;
+  }
+
+  memset(cfg, 0, sizeof(iis3dwb_cfg_t));
+
+  bytecpy((uint8_t *)&pin_ctrl, &img->ctrl[IIS3DWB_PIN_CTRL - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&fifo_ctrl1, &img->ctrl[IIS3DWB_FIFO_CTRL1 - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&fifo_ctrl2, &img->ctrl[IIS3DWB_FIFO_CTRL2 - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&fifo_ctrl3, &img->ctrl[IIS3DWB_FIFO_CTRL3 - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&fifo_ctrl4, &img->ctrl[IIS3DWB_FIFO_CTRL4 - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&counter_bdr_reg1,
+          &img->ctrl[IIS3DWB_COUNTER_BDR_REG1 - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&counter_bdr_reg2,
+          &img->ctrl[IIS3DWB_COUNTER_BDR_REG2 - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&int1_ctrl, &img->ctrl[IIS3DWB_INT1_CTRL - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&int2_ctrl, &img->ctrl[IIS3DWB_INT2_CTRL - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl1_xl, &img->ctrl[IIS3DWB_CTRL1_XL - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl3_c, &img->ctrl[IIS3DWB_CTRL3_C - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl4_c, &img->ctrl[IIS3DWB_CTRL4_C - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl5_c, &img->ctrl[IIS3DWB_CTRL5_C - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl6_c, &img->ctrl[IIS3DWB_CTRL6_C - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl7_c, &img->ctrl[IIS3DWB_CTRL7_C - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl8_xl, &img->ctrl[IIS3DWB_CTRL8_XL - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&ctrl10_c, &img->ctrl[IIS3DWB_CTRL10_C - IIS3DWB_PIN_CTRL]);
+  bytecpy((uint8_t *)&slope_en, &img->md[IIS3DWB_SLOPE_EN - IIS3DWB_SLOPE_EN]);
+  bytecpy((uint8_t *)&wake_up_ths, &img->md[IIS3DWB_WAKE_UP_THS - IIS3DWB_SLOPE_EN]);
+  bytecpy((uint8_t *)&wake_up_dur, &img->md[IIS3DWB_WAKE_UP_DUR - IIS3DWB_SLOPE_EN]);
+  bytecpy((uint8_t *)&md1_cfg, &img->md[IIS3DWB_MD1_CFG - IIS3DWB_SLOPE_EN]);
+  bytecpy((uint8_t *)&md2_cfg, &img->md[IIS3DWB_MD2_CFG - IIS3DWB_SLOPE_EN]);
+
+  cfg->odr_xl = (iis3dwb_odr_xl_t)ctrl1_xl.xl_en;
+  cfg->fs_xl = (iis3dwb_fs_xl_t)ctrl1_xl.fs_xl;
+  cfg->filt_xl = (iis3dwb_filt_xl_en_t)((ctrl1_xl.lpf2_xl_en << 7) +
+                                        (ctrl8_xl.hp_ref_mode_xl << 5) +
+                                        (ctrl8_xl.fds << 4) +
+                                        ctrl8_xl.hpcf_xl);
+  cfg->axis_sel = (iis3dwb_xl_axis_sel_t)((ctrl4_c._1ax_to_3regout << 4) +
+                                          ctrl6_c.xl_axis_sel);
+  cfg->rounding = (iis3dwb_rounding_t)ctrl5_c.rounding;
+  cfg->drdy_pulsed = (iis3dwb_dataready_pulsed_t)counter_bdr_reg1.dataready_pulsed;
+  cfg->pp_od = (iis3dwb_pp_od_t)ctrl3_c.pp_od;
+  cfg->h_lactive = (iis3dwb_h_lactive_t)ctrl3_c.h_lactive;
+  cfg->lir = (iis3dwb_lir_t)slope_en.lir;
+  cfg->sdo_pu_en = (iis3dwb_sdo_pu_en_t)pin_ctrl.sdo_pu_en;
+  cfg->sim = (iis3dwb_sim_t)ctrl3_c.sim;
+  cfg->i2c_disable = (iis3dwb_i2c_disable_t)ctrl4_c.i2c_disable;
+
+  cfg->fifo_xl_batch = (iis3dwb_bdr_xl_t)fifo_ctrl3.bdr_xl;
+  cfg->fifo_temp_batch = (iis3dwb_odr_t_batch_t)fifo_ctrl4.odr_t_batch;
+  cfg->fifo_ts_batch = (iis3dwb_fifo_timestamp_batch_t)fifo_ctrl4.odr_ts_batch;
+  cfg->fifo_mode = (iis3dwb_fifo_mode_t)fifo_ctrl4.fifo_mode;
+
+  cfg->int1_route.drdy_xl = int1_ctrl.int1_drdy_xl;
+  cfg->int1_route.boot = int1_ctrl.int1_boot;
+  cfg->int1_route.fifo_th = int1_ctrl.int1_fifo_th;
+  cfg->int1_route.fifo_ovr = int1_ctrl.int1_fifo_ovr;
+  cfg->int1_route.fifo_full = int1_ctrl.int1_fifo_full;
+  cfg->int1_route.fifo_bdr = int1_ctrl.int1_cnt_bdr;
+  cfg->int1_route.wake_up = md1_cfg.int1_wu;
+
+  cfg->int2_route.drdy_xl = int2_ctrl.int2_drdy_xl;
+  cfg->int2_route.drdy_temp = int2_ctrl.int2_drdy_temp;
+  cfg->int2_route.fifo_th = int2_ctrl.int2_fifo_th;
+  cfg->int2_route.fifo_ovr = int2_ctrl.int2_fifo_ovr;
+  cfg->int2_route.fifo_full = int2_ctrl.int2_fifo_full;
+  cfg->int2_route.fifo_bdr = int2_ctrl.int2_cnt_bdr;
+  cfg->int2_route.timestamp = md2_cfg.int2_timestamp;
+  cfg->int2_route.wake_up = md2_cfg.int2_wu;
+
+  /* sleep_status_on_int selects which event the sleep_change bits route */
+  if (slope_en.sleep_status_on_int != 0U)
+  {
+    cfg->int1_route.sleep_status = md1_cfg.int1_sleep_change;
+    cfg->int2_route.sleep_status = md2_cfg.int2_sleep_change;
+  }
+  else
+  {
+    cfg->int1_route.sleep_change = md1_cfg.int1_sleep_change;
+    cfg->int2_route.sleep_change = md2_cfg.int2_sleep_change;
+  }
+
+  cfg->hp_path_internal = (iis3dwb_slope_fds_t)slope_en.slope_fds;
+  cfg->wkup_ths_w = (iis3dwb_wake_ths_w_t)wake_up_dur.wake_ths_w;
+  cfg->usr_off_w = (iis3dwb_usr_off_w_t)ctrl6_c.usr_off_w;
+
+  cfg->fifo_wtm = fifo_ctrl2.wtm;
+  cfg->fifo_wtm = (cfg->fifo_wtm * 256U) + fifo_ctrl1.wtm;
+  cfg->cnt_bdr_th = counter_bdr_reg1.cnt_bdr_th;
+  cfg->cnt_bdr_th = (cfg->cnt_bdr_th * 256U) + counter_bdr_reg2.cnt_bdr_th;
+
+  cfg->bdu = ctrl3_c.bdu;
+  cfg->timestamp_en = ctrl10_c.timestamp_en;
+  cfg->fast_settling = ctrl8_xl.fastsettl_mode_xl;
+  cfg->drdy_mask = ctrl4_c.drdy_mask;
+  cfg->all_on_int1 = ctrl4_c.int2_on_int1;
+  cfg->fifo_stop_on_wtm = fifo_ctrl2.stop_on_wtm;
+  cfg->wkup_ths = wake_up_ths.wk_ths;
+  cfg->wkup_dur = wake_up_dur.wake_dur;
+  cfg->sleep_dur = wake_up_dur.sleep_dur;
+  cfg->usr_off_on_wkup = wake_up_ths.usr_off_on_wu;
+  cfg->usr_off_on_out = ctrl7_c.usr_off_on_out;
+
+  for (i = 0U; i < 3U; i++)
+  {
+    cfg->usr_offset[i] = (int8_t)img->ofs_usr[i];
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Read the whole device configuration with three burst
+  *         transactions.[get]
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  val    Device configuration.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_cfg_get(const stmdev_ctx_t *ctx, iis3dwb_cfg_t *val)
+{
+  iis3dwb_cfg_img_t img;
+
+  int32_t ret = iis3dwb_cfg_img_get(ctx, &img);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_cfg_img_decode(&img, val);
+  }
+
+  return ret;
+}
+
+static uint8_t cfg_route_diff(const iis3dwb_pin_int_route_t *a,
+                              const iis3dwb_pin_int_route_t *b)
+{
+  return ((a->drdy_xl != b->drdy_xl) || (a->boot != b->boot) ||
+          (a->drdy_temp != b->drdy_temp) || (a->fifo_th != b->fifo_th) ||
+          (a->fifo_ovr != b->fifo_ovr) || (a->fifo_full != b->fifo_full) ||
+          (a->fifo_bdr != b->fifo_bdr) || (a->timestamp != b->timestamp) ||
+          (a->wake_up != b->wake_up) ||
+          (a->sleep_change != b->sleep_change) ||
+          (a->sleep_status != b->sleep_status)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Compare two device configurations.
+  *
+  * @param  cfg    Device configuration (e.g. from iis3dwb_cfg_get).(ptr)
+  * @param  ref    Expected device configuration.(ptr)
+  * @retval        Mask of IIS3DWB_CFG_DIFF_* groups that differ,
+  *                0 -> configurations match.
+  *
+  */
+uint32_t iis3dwb_cfg_diff(const iis3dwb_cfg_t *cfg, const iis3dwb_cfg_t *ref)
+{
+  uint32_t diff = 0U;
+
+  if (cfg->odr_xl != ref->odr_xl)
+  {
+    diff |= IIS3DWB_CFG_DIFF_XL_ODR;
+  }
+
+  if (cfg->fs_xl != ref->fs_xl)
+  {
+    diff |= IIS3DWB_CFG_DIFF_XL_FS;
+  }
+
+  if ((cfg->filt_xl != ref->filt_xl) ||
+      (cfg->fast_settling != ref->fast_settling) ||
+      (cfg->hp_path_internal != ref->hp_path_internal))
+  {
+    diff |= IIS3DWB_CFG_DIFF_XL_FILT;
+  }
+
+  if (cfg->axis_sel != ref->axis_sel)
+  {
+    diff |= IIS3DWB_CFG_DIFF_XL_AXIS;
+  }
+
+  if ((cfg->bdu != ref->bdu) || (cfg->rounding != ref->rounding) ||
+      (cfg->drdy_pulsed != ref->drdy_pulsed) ||
+      (cfg->drdy_mask != ref->drdy_mask) ||
+      (cfg->timestamp_en != ref->timestamp_en))
+  {
+    diff |= IIS3DWB_CFG_DIFF_DATA;
+  }
+
+  if ((cfg->pp_od != ref->pp_od) || (cfg->h_lactive != ref->h_lactive) ||
+      (cfg->lir != ref->lir) || (cfg->sdo_pu_en != ref->sdo_pu_en) ||
+      (cfg->sim != ref->sim) || (cfg->i2c_disable != ref->i2c_disable) ||
+      (cfg->all_on_int1 != ref->all_on_int1))
+  {
+    diff |= IIS3DWB_CFG_DIFF_PIN;
+  }
+
+  if ((cfg->fifo_xl_batch != ref->fifo_xl_batch) ||
+      (cfg->fifo_temp_batch != ref->fifo_temp_batch) ||
+      (cfg->fifo_ts_batch != ref->fifo_ts_batch) ||
+      (cfg->fifo_mode != ref->fifo_mode) ||
+      (cfg->fifo_wtm != ref->fifo_wtm) ||
+      (cfg->fifo_stop_on_wtm != ref->fifo_stop_on_wtm))
+  {
+    diff |= IIS3DWB_CFG_DIFF_FIFO;
+  }
+
+  if (cfg->cnt_bdr_th != ref->cnt_bdr_th)
+  {
+    diff |= IIS3DWB_CFG_DIFF_BDR_CNT;
+  }
+
+  if (cfg_route_diff(&cfg->int1_route, &ref->int1_route) != 0U)
+  {
+    diff |= IIS3DWB_CFG_DIFF_INT1_ROUTE;
+  }
+
+  if (cfg_route_diff(&cfg->int2_route, &ref->int2_route) != 0U)
+  {
+    diff |= IIS3DWB_CFG_DIFF_INT2_ROUTE;
+  }
+
+  if ((cfg->wkup_ths_w != ref->wkup_ths_w) ||
+      (cfg->wkup_ths != ref->wkup_ths) || (cfg->wkup_dur != ref->wkup_dur) ||
+      (cfg->sleep_dur != ref->sleep_dur) ||
+      (cfg->usr_off_on_wkup != ref->usr_off_on_wkup))
+  {
+    diff |= IIS3DWB_CFG_DIFF_WKUP;
+  }
+
+  if ((cfg->usr_off_w != ref->usr_off_w) ||
+      (cfg->usr_off_on_out != ref->usr_off_on_out) ||
+      (cfg->usr_offset[0] != ref->usr_offset[0]) ||
+      (cfg->usr_offset[1] != ref->usr_offset[1]) ||
+      (cfg->usr_offset[2] != ref->usr_offset[2]))
+  {
+    diff |= IIS3DWB_CFG_DIFF_USR_OFFSET;
+  }
+
+  return diff;
+}
+
+/**
+  * @brief  Read the device configuration and compare it with the
+  *         expected one.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  ref    Expected device configuration.(ptr)
+  * @param  diff   Mask of IIS3DWB_CFG_DIFF_* groups that differ.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_cfg_verify(const stmdev_ctx_t *ctx, const iis3dwb_cfg_t *ref,
+                           uint32_t *diff)
+{
+  iis3dwb_cfg_t cfg;
+
+  int32_t ret = iis3dwb_cfg_get(ctx, &cfg);
+
+  if (ret == 0)
+  {
+    *diff = iis3dwb_cfg_diff(&cfg, ref);
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_ucf UCF Configuration Loader
+  * @brief      This section groups the functions that load a configuration
+  *             exported as ucf_line_t sequence (e.g. from Unico).
+  * @{
+  *
+  */
+
+/* Registers holding self-clearing bits: never considered redundant. */
+static uint8_t ucf_is_volatile(uint8_t reg)
+{
+  return ((reg == IIS3DWB_CTRL3_C) || (reg == IIS3DWB_COUNTER_BDR_REG1) ||
+          (reg == IIS3DWB_TIMESTAMP2)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Load a UCF configuration. Lines targeting consecutive
+  *         addresses are merged into auto-increment bursts and lines
+  *         writing a register with the value already written by a
+  *         previous line are dropped. Line order is preserved.
+  *         Optionally the registers are read back, in bursts too, and
+  *         compared with the last value written.[set]
+  *
+  * @param  ctx       Read / write interface definitions.(ptr)
+  * @param  ucf       Configuration lines.(ptr)
+  * @param  len       Number of configuration lines.
+  * @param  mismatch  Number of registers whose read back value differs,
+  *                   NULL to skip the verification.(ptr)
+  * @retval           Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_ucf_load(const stmdev_ctx_t *ctx, const ucf_line_t *ucf,
+                         uint16_t len, uint16_t *mismatch)
+{
+  uint8_t shadow[128];
+  uint8_t valid[16];
+  uint8_t buff[16];
+  uint8_t start;
+  uint8_t reg;
+  uint8_t n;
+  uint16_t i;
+  int32_t ret = 0;
+
+  if (ucf == NULL)
+  {
+    return -1;
+  }
+
+  for (i = 0U; i < len; i++)
+  {
+    if (ucf[i].address > 0x7FU)
+    {
+      return -1;
+    }
+  }
+
+  memset(valid, 0, sizeof(valid));
+
+  i = 0U;
+  while ((ret == 0) && (i < len))
+  {
+    start = ucf[i].address;
+
+    /* a run is never started by a redundant line */
+    if ((ucf_is_volatile(start) == 0U) &&
+        ((valid[start >> 3] & (uint8_t)(1U << (start & 0x07U))) != 0U) &&
+        (shadow[start] == ucf[i].data))
+    {
+      i++;
+    }
+    else
+    {
+      n = 0U;
+      while ((i < len) && (n < (uint8_t)sizeof(buff)) &&
+             (ucf[i].address == (uint8_t)(start + n)))
+      {
+        reg = ucf[i].address;
+        buff[n] = ucf[i].data;
+        shadow[reg] = ucf[i].data;
+        valid[reg >> 3] |= (uint8_t)(1U << (reg & 0x07U));
+        n++;
+        i++;
+      }
+
+      ret = iis3dwb_write_reg(ctx, start, buff, n);
+    }
+  }
+
+  if ((ret != 0) || (mismatch == NULL))
+  {
+    return ret;
+  }
+
+  *mismatch = 0U;
+
+  reg = 0U;
+  while ((ret == 0) && (reg < 0x80U))
+  {
+    start = reg;
+    n = 0U;
+    while ((reg < 0x80U) && (n < (uint8_t)sizeof(buff)) &&
+           (ucf_is_volatile(reg) == 0U) &&
+           ((valid[reg >> 3] & (uint8_t)(1U << (reg & 0x07U))) != 0U))
+    {
+      n++;
+      reg++;
+    }
+
+    if (n == 0U)
+    {
+      reg++;
+    }
+    else
+    {
+      ret = iis3dwb_read_reg(ctx, start, buff, n);
+
+      for (i = 0U; (ret == 0) && (i < n); i++)
+      {
+        if (buff[i] != shadow[start + i])
+        {
+          (*mismatch)++;
+        }
+      }
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_init Device Initialization
+  * @brief      This section groups the functions that bring one or more
+  *             devices from power-on to the first output sample.
+  * @{
+  *
+  */
+
+#define IIS3DWB_INIT_PENDING                 0xFFFFFFFFU
+
+/*
+ * Poll reg on all the pending devices until (reg & mask) == done, sharing
+ * the same bounded exponential backoff. ttfs of each device is set to the
+ * elapsed time (ms) at which its condition was met.
+ */
+static void init_wait(const stmdev_ctx_t *const ctx[], uint8_t num,
+                      uint8_t reg, uint8_t mask, uint8_t done,
+                      uint32_t *ttfs, int32_t *status, uint32_t *elapsed)
+{
+  stmdev_mdelay_ptr mdelay = NULL;
+  uint32_t start = *elapsed;
+  uint32_t wait = 0U;
+  uint8_t pending;
+  uint8_t data;
+  uint8_t i;
+
+  for (i = 0U; i < num; i++)
+  {
+    if (status[i] == 0)
+    {
+      ttfs[i] = IIS3DWB_INIT_PENDING;
+
+      if (mdelay == NULL)
+      {
+        mdelay = ctx[i]->mdelay;
+      }
+    }
+  }
+
+  do
+  {
+    if (wait != 0U)
+    {
+      mdelay(wait);
+      *elapsed += wait;
+    }
+
+    pending = 0U;
+    for (i = 0U; i < num; i++)
+    {
+      if ((status[i] == 0) && (ttfs[i] == IIS3DWB_INIT_PENDING))
+      {
+        data = 0U;
+        status[i] = iis3dwb_read_reg(ctx[i], reg, &data, 1);
+
+        if ((status[i] == 0) && ((data & mask) == done))
+        {
+          ttfs[i] = *elapsed;
+        }
+        else
+        {
+          pending++;
+        }
+      }
+    }
+
+    wait = (wait == 0U) ? 1U : (wait * 2U);
+    if ((*elapsed + wait) > (start + IIS3DWB_INIT_TIMEOUT_MS))
+    {
+      wait = (start + IIS3DWB_INIT_TIMEOUT_MS) - *elapsed;
+    }
+  } while ((pending != 0U) && (wait != 0U));
+
+  for (i = 0U; i < num; i++)
+  {
+    if ((status[i] == 0) && (ttfs[i] == IIS3DWB_INIT_PENDING))
+    {
+      ttfs[i] = *elapsed;
+      status[i] = -1;
+    }
+  }
+}
+
+/**
+  * @brief  Bring a set of devices from power-on to the first sample:
+  *         wait for the device id, software reset, apply the register
+  *         image with burst writes and wait for the first accelerometer
+  *         sample (only if the image enables the accelerometer).
+  *         Each step is issued to all the devices before polling any of
+  *         them, and the polling of all the devices shares the same
+  *         bounded backoff (IIS3DWB_INIT_TIMEOUT_MS per step) based on
+  *         the mdelay routine of the first device, so the startup time
+  *         does not grow with the number of devices.
+  *
+  * @param  ctx     Read / write interface definitions of the devices.
+  * @param  num     Number of devices.
+  * @param  img     Register image applied to all the devices.(ptr)
+  * @param  ttfs    Time to first sample of each device, in ms as waited
+  *                 through mdelay (bus transfer time not included).
+  * @param  status  Status of each device: 0 -> ready, -1 -> no mdelay
+  *                 routine, wrong id or timeout, other -> interface
+  *                 status.
+  * @retval         0 -> all the devices ready, otherwise the status of
+  *                 the first failed one.
+  *
+  */
+int32_t iis3dwb_init_multi(const stmdev_ctx_t *const ctx[], uint8_t num,
+                           const iis3dwb_cfg_img_t *img, uint32_t *ttfs,
+                           int32_t *status)
+{
+  iis3dwb_ctrl3_c_t ctrl3_c = {0};
+  uint32_t elapsed = 0U;
+  uint8_t i;
+
+  if ((ctx == NULL) || (img == NULL) || (ttfs == NULL) || (status == NULL))
+  {
+    return -1;
+  }
+
+  /* the backoff needs a real delay, the bus time alone is unbounded */
+  for (i = 0U; i < num; i++)
+  {
+    status[i] = ((ctx[i] == NULL) || (ctx[i]->mdelay == NULL)) ? -1 : 0;
+  }
+
+  /* the device answers with its id once the boot is completed */
+  init_wait(ctx, num, IIS3DWB_WHO_AM_I, 0xFFU, IIS3DWB_ID,
+            ttfs, status, &elapsed);
+
+  ctrl3_c.sw_reset = PROPERTY_ENABLE;
+  ctrl3_c.if_inc = PROPERTY_ENABLE;
+  for (i = 0U; i < num; i++)
+  {
+    if (status[i] == 0)
+    {
+      status[i] = iis3dwb_write_reg(ctx[i], IIS3DWB_CTRL3_C,
+                                    (uint8_t *)&ctrl3_c, 1);
+    }
+  }
+
+  init_wait(ctx, num, IIS3DWB_CTRL3_C, IIS3DWB_CTRL3_C_SW_RESET_MSK, 0U,
+            ttfs, status, &elapsed);
+
+  for (i = 0U; i < num; i++)
+  {
+    if (status[i] == 0)
+    {
+      status[i] = iis3dwb_cfg_img_write(ctx[i], img);
+    }
+  }
+
+  if ((img->ctrl[IIS3DWB_CTRL1_XL - IIS3DWB_PIN_CTRL] &
+       IIS3DWB_CTRL1_XL_XL_EN_MSK) != 0U)
+  {
+    init_wait(ctx, num, IIS3DWB_STATUS_REG, IIS3DWB_STATUS_REG_XLDA_MSK,
+              IIS3DWB_STATUS_REG_XLDA_MSK, ttfs, status, &elapsed);
+  }
+
+  for (i = 0U; i < num; i++)
+  {
+    if (status[i] != 0)
+    {
+      return status[i];
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Bring a device from power-on to the first sample.
+  *         See iis3dwb_init_multi.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  img    Register image to apply.(ptr)
+  * @param  ttfs   Time to first sample, in ms as waited through mdelay.
+  * @retval        0 -> device ready, -1 -> no mdelay routine, wrong id
+  *                or timeout, other -> interface status.
+  *
+  */
+int32_t iis3dwb_init(const stmdev_ctx_t *ctx, const iis3dwb_cfg_img_t *img,
+                     uint32_t *ttfs)
+{
+  const stmdev_ctx_t *const dev[1] = { ctx };
+  int32_t status = 0;
+
+  return iis3dwb_init_multi(dev, 1U, img, ttfs, &status);
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_self_test Self-Test Procedure
+  * @brief      This section groups the functions that run the
+  *             accelerometer self-test procedure on FIFO averaged data.
+  * @{
+  *
+  */
+
+#define FIFO_CHUNK                           32U
+#define FIFO_MEAN_TIMEOUT_MS                 20U
+
+/*
+ * Restart the FIFO in stream mode and average num accelerometer samples
+ * after discarding the first ones. The FIFO must batch the accelerometer.
+ */
+static int32_t fifo_xl_mean_get(const stmdev_ctx_t *ctx, uint16_t discard,
+                                uint16_t num, float_t *mean)
+{
+  iis3dwb_fifo_out_raw_t fdata[FIFO_CHUNK];
+  iis3dwb_fifo_status_t status = {0};
+  int32_t sum[3] = {0};
+  int16_t xl;
+  uint16_t skip = discard;
+  uint16_t cnt = 0U;
+  uint16_t len;
+  uint16_t i;
+  uint8_t idle = 0U;
+  uint8_t j;
+  int32_t ret;
+
+  /* the timeout needs a real delay, the bus time alone is unbounded */
+  if ((num == 0U) || (ctx->mdelay == NULL))
+  {
+    return -1;
+  }
+
+  ret = iis3dwb_fifo_mode_set(ctx, IIS3DWB_BYPASS_MODE);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_fifo_mode_set(ctx, IIS3DWB_STREAM_MODE);
+  }
+
+  while ((ret == 0) && (cnt < num))
+  {
+    ret = iis3dwb_fifo_status_get(ctx, &status);
+    len = (status.fifo_level > FIFO_CHUNK) ?
+          FIFO_CHUNK : status.fifo_level;
+
+    if ((ret == 0) && (len == 0U))
+    {
+      if (idle < FIFO_MEAN_TIMEOUT_MS)
+      {
+        ctx->mdelay(1);
+        idle++;
+      }
+      else
+      {
+        ret = -1;
+      }
+    }
+    else if (ret == 0)
+    {
+      idle = 0U;
+      ret = iis3dwb_fifo_out_multi_raw_get(ctx, fdata, len);
+
+      for (i = 0U; (ret == 0) && (i < len) && (cnt < num); i++)
+      {
+        if (IIS3DWB_FIELD_GET(IIS3DWB_FIFO_DATA_OUT_TAG_TAG_SENSOR,
+                              fdata[i].tag) != (uint8_t)IIS3DWB_XL_TAG)
+        {
+          /* not an accelerometer sample */
+        }
+        else if (skip > 0U)
+        {
+          skip--;
+        }
+        else
+        {
+          for (j = 0U; j < 3U; j++)
+          {
+            xl = (int16_t)fdata[i].data[(2U * j) + 1U];
+            xl = (xl * 256) + (int16_t)fdata[i].data[2U * j];
+            sum[j] += xl;
+          }
+          cnt++;
+        }
+      }
+    }
+    else
+    {
+      /* interface error */
+    }
+  }
+
+  if (ret == 0)
+  {
+    for (j = 0U; j < 3U; j++)
+    {
+      mean[j] = (float_t)sum[j] / (float_t)num;
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Run the accelerometer self-test procedure.
+  *         The device is configured at 26.7 kHz, 4 g full scale with the
+  *         accelerometer batched in FIFO; for each self-test mode
+  *         (disabled, positive, negative) the output is left settling
+  *         for IIS3DWB_ST_SETTLE_MS, the first IIS3DWB_ST_DISCARD samples
+  *         are dropped and the next IIS3DWB_ST_SAMPLES are averaged.
+  *         An axis passes when both the positive and the negative
+  *         deltas are inside [IIS3DWB_ST_MIN_MG, IIS3DWB_ST_MAX_MG].
+  *         The previous device configuration is restored at the end,
+  *         the FIFO content is lost.
+  *         The device must be still during the test.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  val    Self-test averages, deltas and pass/fail.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error),
+  *                -1 also without mdelay routine or if the FIFO does not
+  *                fill in time.
+  *
+  */
+int32_t iis3dwb_xl_self_test_run(const stmdev_ctx_t *ctx,
+                                 iis3dwb_xl_st_result_t *val)
+{
+  const iis3dwb_st_xl_t mode[3] =
+  {
+    IIS3DWB_XL_ST_DISABLE, IIS3DWB_XL_ST_POSITIVE, IIS3DWB_XL_ST_NEGATIVE
+  };
+  iis3dwb_cfg_t cfg = {0};
+  iis3dwb_cfg_img_t saved;
+  iis3dwb_cfg_img_t img;
+  float_t mean[3][3] = {{0.0f}};
+  float_t pos;
+  float_t neg;
+  uint8_t i;
+  uint8_t j;
+  int32_t ret;
+
+  if ((ctx == NULL) || (ctx->mdelay == NULL) || (val == NULL))
+  {
+    return -1;
+  }
+
+  ret = iis3dwb_cfg_img_get(ctx, &saved);
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  cfg.odr_xl = IIS3DWB_XL_ODR_26k7Hz;
+  cfg.fs_xl = IIS3DWB_4g;
+  cfg.bdu = PROPERTY_ENABLE;
+  cfg.fifo_xl_batch = IIS3DWB_XL_BATCHED_AT_26k7Hz;
+  cfg.fifo_mode = IIS3DWB_BYPASS_MODE;
+  ret = iis3dwb_cfg_img_build(&cfg, &img);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_cfg_img_write(ctx, &img);
+  }
+
+  for (i = 0U; (ret == 0) && (i < 3U); i++)
+  {
+    ret = iis3dwb_xl_self_test_set(ctx, mode[i]);
+
+    if (ret == 0)
+    {
+      ctx->mdelay(IIS3DWB_ST_SETTLE_MS);
+      ret = fifo_xl_mean_get(ctx, IIS3DWB_ST_DISCARD, IIS3DWB_ST_SAMPLES,
+                             mean[i]);
+    }
+  }
+
+  if (ret == 0)
+  {
+    val->axis_pass = 0U;
+    for (j = 0U; j < 3U; j++)
+    {
+      val->mean_mg[j] = mean[0][j] * iis3dwb_from_fs4g_to_mg(1);
+      pos = (mean[1][j] - mean[0][j]) * iis3dwb_from_fs4g_to_mg(1);
+      neg = (mean[0][j] - mean[2][j]) * iis3dwb_from_fs4g_to_mg(1);
+      val->pos_mg[j] = pos;
+      val->neg_mg[j] = neg;
+
+      if ((pos >= IIS3DWB_ST_MIN_MG) && (pos <= IIS3DWB_ST_MAX_MG) &&
+          (neg >= IIS3DWB_ST_MIN_MG) && (neg <= IIS3DWB_ST_MAX_MG))
+      {
+        val->axis_pass |= (uint8_t)(1U << j);
+      }
+    }
+    val->pass = (val->axis_pass == 0x07U) ? 1U : 0U;
+  }
+
+  /* restore the previous configuration also after a failure */
+  if (iis3dwb_cfg_img_write(ctx, &saved) != 0)
+  {
+    ret = (ret == 0) ? -1 : ret;
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_offset_calibration Offset Calibration
+  * @brief      This section groups the functions that compute and program
+  *             the accelerometer user offset.
+  * @{
+  *
+  */
+
+/* Offset register weight: 2^-10 g and 2^-6 g */
+#define OFS_USR_1MG_WEIGHT                   0.9765625f
+#define OFS_USR_16MG_WEIGHT                  15.625f
+
+static float_t xl_mg_per_lsb(uint8_t fs_xl)
+{
+  float_t sens;
+
+  switch (fs_xl)
+  {
+    case IIS3DWB_2g:
+      sens = iis3dwb_from_fs2g_to_mg(1);
+      break;
+
+    case IIS3DWB_4g:
+      sens = iis3dwb_from_fs4g_to_mg(1);
+      break;
+
+    case IIS3DWB_8g:
+      sens = iis3dwb_from_fs8g_to_mg(1);
+      break;
+
+    case IIS3DWB_16g:
+      sens = iis3dwb_from_fs16g_to_mg(1);
+      break;
+
+    default:
+      sens = iis3dwb_from_fs2g_to_mg(1);
+      break;
+  }
+
+  return sens;
+}
+
+/**
+  * @brief  Compute the accelerometer bias from FIFO averaged data taken
+  *         at rest and program it in X/Y/Z_OFS_USR.
+  *         The weight (1 mg or 16 mg) is the finest one able to hold the
+  *         largest bias; the offset is then applied to the output data
+  *         (usr_off_on_out), which the device subtracts from the
+  *         measurement, so the host no longer corrects each sample.
+  *         Measurements are taken at 26.7 kHz on the current full scale
+  *         after IIS3DWB_OFS_CAL_SETTLE_MS (IIS3DWB_OFS_CAL_DISCARD
+  *         samples dropped, IIS3DWB_OFS_CAL_SAMPLES averaged); the
+  *         residual is measured again with the correction applied.
+  *         The previous device configuration is restored with the new
+  *         offset in place, the FIFO content is lost.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  ref_mg Expected X, Y, Z acceleration at rest (e.g. gravity).
+  * @param  val    Measured bias, residual and programmed offset.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error),
+  *                -1 also without mdelay routine or if the FIFO does not
+  *                fill in time.
+  *
+  */
+int32_t iis3dwb_xl_offset_calibrate(const stmdev_ctx_t *ctx,
+                                    const float_t *ref_mg,
+                                    iis3dwb_xl_offset_cal_t *val)
+{
+  iis3dwb_cfg_t cfg = {0};
+  iis3dwb_cfg_img_t saved;
+  iis3dwb_cfg_img_t img;
+  float_t mean[3];
+  float_t max = 0.0f;
+  float_t weight;
+  float_t sens;
+  float_t ofs;
+  uint8_t fs_xl;
+  uint8_t j;
+  int32_t ret;
+
+  if ((ctx == NULL) || (ctx->mdelay == NULL) || (ref_mg == NULL) ||
+      (val == NULL))
+  {
+    return -1;
+  }
+
+  ret = iis3dwb_cfg_img_get(ctx, &saved);
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  /* plain DC measurement: no high-pass, no offset, XL only in FIFO */
+  cfg.odr_xl = IIS3DWB_XL_ODR_26k7Hz;
+  fs_xl = saved.ctrl[IIS3DWB_CTRL1_XL - IIS3DWB_PIN_CTRL];
+  cfg.fs_xl = (iis3dwb_fs_xl_t)IIS3DWB_FIELD_GET(IIS3DWB_CTRL1_XL_FS_XL, fs_xl);
+  cfg.bdu = PROPERTY_ENABLE;
+  cfg.fifo_xl_batch = IIS3DWB_XL_BATCHED_AT_26k7Hz;
+  cfg.fifo_mode = IIS3DWB_BYPASS_MODE;
+  sens = xl_mg_per_lsb((uint8_t)cfg.fs_xl);
+
+  ret = iis3dwb_cfg_img_build(&cfg, &img);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_cfg_img_write(ctx, &img);
+  }
+
+  if (ret == 0)
+  {
+    ctx->mdelay(IIS3DWB_OFS_CAL_SETTLE_MS);
+    ret = fifo_xl_mean_get(ctx, IIS3DWB_OFS_CAL_DISCARD,
+                           IIS3DWB_OFS_CAL_SAMPLES, mean);
+  }
+
+  if (ret == 0)
+  {
+    for (j = 0U; j < 3U; j++)
+    {
+      val->bias_mg[j] = (mean[j] * sens) - ref_mg[j];
+      ofs = (val->bias_mg[j] < 0.0f) ? -val->bias_mg[j] : val->bias_mg[j];
+      max = (ofs > max) ? ofs : max;
+    }
+
+    if (max <= (127.0f * OFS_USR_1MG_WEIGHT))
+    {
+      val->weight = IIS3DWB_LSb_1mg;
+      weight = OFS_USR_1MG_WEIGHT;
+    }
+    else
+    {
+      val->weight = IIS3DWB_LSb_16mg;
+      weight = OFS_USR_16MG_WEIGHT;
+    }
+
+    for (j = 0U; j < 3U; j++)
+    {
+      ofs = val->bias_mg[j] / weight;
+      ofs = (ofs > 127.0f) ? 127.0f : ofs;
+      ofs = (ofs < -127.0f) ? -127.0f : ofs;
+      ofs += (ofs < 0.0f) ? -0.5f : 0.5f;
+      val->offset[j] = (int8_t)ofs;
+      cfg.usr_offset[j] = val->offset[j];
+    }
+
+    cfg.usr_off_w = val->weight;
+    cfg.usr_off_on_out = PROPERTY_ENABLE;
+    ret = iis3dwb_cfg_img_build(&cfg, &img);
+  }
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_cfg_img_write(ctx, &img);
+  }
+
+  if (ret == 0)
+  {
+    ctx->mdelay(IIS3DWB_OFS_CAL_SETTLE_MS);
+    ret = fifo_xl_mean_get(ctx, IIS3DWB_OFS_CAL_DISCARD,
+                           IIS3DWB_OFS_CAL_SAMPLES, mean);
+  }
+
+  if (ret == 0)
+  {
+    for (j = 0U; j < 3U; j++)
+    {
+      val->residual_mg[j] = (mean[j] * sens) - ref_mg[j];
+      saved.ofs_usr[j] = (uint8_t)val->offset[j];
+    }
+
+    j = IIS3DWB_CTRL6_C - IIS3DWB_PIN_CTRL;
+    saved.ctrl[j] &= (uint8_t)~IIS3DWB_CTRL6_C_USR_OFF_W_MSK;
+    saved.ctrl[j] |= IIS3DWB_FIELD_PREP(IIS3DWB_CTRL6_C_USR_OFF_W, val->weight);
+    j = IIS3DWB_CTRL7_C - IIS3DWB_PIN_CTRL;
+    saved.ctrl[j] |= IIS3DWB_CTRL7_C_USR_OFF_ON_OUT_MSK;
+  }
+
+  /* restore the previous configuration also after a failure */
+  if (iis3dwb_cfg_img_write(ctx, &saved) != 0)
+  {
+    ret = (ret == 0) ? -1 : ret;
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_capture Event Capture
+  * @brief      This section groups the functions that capture windows of
+  *             accelerometer data around wake-up events.
+  * @{
+  *
+  */
+
+/**
+  * @brief  Initialize an event capture engine.
+  *         The ring keeps the last pre samples on the host; on a wake-up
+  *         event, a window of pre + post samples is passed to the event
+  *         callback. Nothing is reported between events.
+  *
+  * @param  cap    Capture engine.(ptr)
+  * @param  ring   Sample memory of (pre + post) * 3 elements.(ptr)
+  * @param  pre    Samples kept before the trigger.
+  * @param  post   Samples collected from the trigger on (> 0).
+  * @param  event  Callback receiving the captured windows.
+  * @param  arg    Argument passed to the callback.
+  * @retval        0 -> engine ready, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_capture_init(iis3dwb_capture_t *cap, int16_t *ring,
+                             uint16_t pre, uint16_t post,
+                             iis3dwb_capture_cb_t event, void *arg)
+{
+  if ((cap == NULL) || (ring == NULL) || (event == NULL) || (post == 0U) ||
+      (((uint32_t)pre + post) > 0xFFFFU))
+  {
+    return -1;
+  }
+
+  memset(cap, 0, sizeof(iis3dwb_capture_t));
+  cap->ring = ring;
+  cap->pre = pre;
+  cap->post = post;
+  cap->event = event;
+  cap->arg = arg;
+
+  return 0;
+}
+
+static void capture_emit(iis3dwb_capture_t *cap)
+{
+  iis3dwb_capture_evt_t evt;
+  const uint16_t len = cap->pre + cap->post;
+  const uint16_t win = cap->trig_pre + cap->post;
+  const uint16_t start = (uint16_t)(((uint32_t)cap->head + len - win) % len);
+
+  evt.seg[0] = &cap->ring[3U * start];
+  evt.seg_len[0] = ((len - start) < win) ? (len - start) : win;
+  evt.seg[1] = cap->ring;
+  evt.seg_len[1] = win - evt.seg_len[0];
+  evt.pre = cap->trig_pre;
+  evt.post = cap->post;
+  evt.wake_up_src = cap->wake_up_src;
+
+  cap->event(cap->arg, &evt);
+}
+
+/**
+  * @brief  Feed decoded accelerometer samples to a capture engine.
+  *         A trigger starts a window at the first sample of this call;
+  *         a trigger received while a window is being completed is
+  *         merged into it.
+  *
+  * @param  cap    Capture engine.(ptr)
+  * @param  xl     X, Y, Z samples (3 * num elements).(ptr)
+  * @param  num    Number of samples.
+  * @param  trig   Wake-up source of a new event, NULL if none.
+  *
+  */
+void iis3dwb_capture_feed(iis3dwb_capture_t *cap, const int16_t *xl,
+                          uint16_t num, const iis3dwb_wake_up_src_t *trig)
+{
+  const uint16_t len = cap->pre + cap->post;
+  uint16_t i;
+
+  if ((trig != NULL) && (cap->remaining == 0U))
+  {
+    cap->remaining = cap->post;
+    cap->trig_pre = cap->fill;
+    cap->wake_up_src = *trig;
+  }
+
+  for (i = 0U; i < num; i++)
+  {
+    memcpy(&cap->ring[3U * cap->head], &xl[3U * i], 3U * sizeof(int16_t));
+    cap->head = (cap->head == (len - 1U)) ? 0U : (cap->head + 1U);
+
+    if (cap->remaining == 0U)
+    {
+      cap->fill = (cap->fill < cap->pre) ? (cap->fill + 1U) : cap->pre;
+    }
+    else
+    {
+      cap->remaining--;
+      if (cap->remaining == 0U)
+      {
+        capture_emit(cap);
+        /* the tail of this window is the history of the next one */
+        cap->fill = (cap->post < cap->pre) ? cap->post : cap->pre;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Check the wake-up source and move the FIFO content into a
+  *         capture engine. The FIFO must batch the accelerometer and the
+  *         wake-up detection must be configured. The FIFO level is read
+  *         right after the wake-up source: the words already buffered
+  *         are fed as history and the trigger is placed after them, so
+  *         the trigger resolution is the FIFO latency of the event.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  cap    Capture engine.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_capture_run(const stmdev_ctx_t *ctx, iis3dwb_capture_t *cap)
+{
+  iis3dwb_fifo_out_raw_t fdata[FIFO_CHUNK];
+  int16_t xl[3U * FIFO_CHUNK];
+  iis3dwb_wake_up_src_t wake_up_src = {0};
+  iis3dwb_fifo_status_t status;
+  uint16_t level = 0U;
+  uint16_t len;
+  int32_t ret;
+
+  ret = iis3dwb_read_reg(ctx, IIS3DWB_WAKE_UP_SRC,
+                         (uint8_t *)&wake_up_src, 1);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_fifo_status_get(ctx, &status);
+    level = status.fifo_level;
+  }
+
+  while ((ret == 0) && (level > 0U))
+  {
+    len = (level > FIFO_CHUNK) ? FIFO_CHUNK : level;
+    ret = iis3dwb_fifo_out_multi_raw_get(ctx, fdata, len);
+
+    if (ret == 0)
+    {
+      iis3dwb_capture_feed(cap, xl, iis3dwb_fifo_xl_decode(fdata, len, xl),
+                           NULL);
+      level -= len;
+    }
+  }
+
+  /* the trigger follows the samples buffered when it was read */
+  if ((ret == 0) && (wake_up_src.wu_ia != 0U))
+  {
+    iis3dwb_capture_feed(cap, xl, 0U, &wake_up_src);
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_trig_acq Triggered Acquisition
+  * @brief      This section groups the functions that run the FIFO in
+  *             its trigger based modes with the wake-up event as trigger.
+  * @{
+  *
+  */
+
+static int32_t trig_acq_start(const stmdev_ctx_t *ctx, iis3dwb_trig_acq_t *acq)
+{
+  iis3dwb_all_sources_t src;
+
+  /* empty the FIFO and clear a pending wake-up before arming */
+  int32_t ret = iis3dwb_fifo_mode_set(ctx, IIS3DWB_BYPASS_MODE);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_all_sources_get(ctx, &src);
+  }
+
+  if (ret == 0)
+  {
+    acq->triggered = 0U;
+    ret = iis3dwb_fifo_mode_set(ctx, acq->mode);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Arm a triggered acquisition.
+  *         In STREAM_TO_FIFO mode the FIFO keeps the history before the
+  *         wake-up event and freezes once it is full; in BYPASS_TO_FIFO
+  *         mode it starts storing at the wake-up event.
+  *         The accelerometer must be batched in FIFO, the wake-up event
+  *         configured and routed on INT1 or INT2; interrupts are set
+  *         latched so the trigger source can be read back, the previous
+  *         notification mode is restored by iis3dwb_trig_acq_disarm.
+  *         Route fifo_full on a pin to be notified of the end of the
+  *         acquisition without any host activity while waiting.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  acq    Acquisition state.(ptr)
+  * @param  mode   IIS3DWB_STREAM_TO_FIFO_MODE or IIS3DWB_BYPASS_TO_FIFO_MODE
+  * @retval        Interface status (MANDATORY: return 0 -> no Error),
+  *                -1 also for an unsupported mode.
+  *
+  */
+int32_t iis3dwb_trig_acq_arm(const stmdev_ctx_t *ctx, iis3dwb_trig_acq_t *acq,
+                             iis3dwb_fifo_mode_t mode)
+{
+  int32_t ret;
+
+  if ((acq == NULL) || ((mode != IIS3DWB_STREAM_TO_FIFO_MODE) &&
+                        (mode != IIS3DWB_BYPASS_TO_FIFO_MODE)))
+  {
+    return -1;
+  }
+
+  memset(acq, 0, sizeof(iis3dwb_trig_acq_t));
+  acq->mode = mode;
+
+  ret = iis3dwb_int_notification_get(ctx, &acq->lir);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_int_notification_set(ctx, IIS3DWB_INT_LATCHED);
+  }
+
+  if (ret == 0)
+  {
+    ret = trig_acq_start(ctx, acq);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Stop a triggered acquisition: the FIFO is set in BYPASS mode
+  *         (its content is lost) and the interrupt notification mode
+  *         in use before iis3dwb_trig_acq_arm is restored.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  acq    Acquisition state.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_trig_acq_disarm(const stmdev_ctx_t *ctx,
+                                const iis3dwb_trig_acq_t *acq)
+{
+  int32_t ret;
+
+  if (acq == NULL)
+  {
+    return -1;
+  }
+
+  ret = iis3dwb_fifo_mode_set(ctx, IIS3DWB_BYPASS_MODE);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_int_notification_set(ctx, acq->lir);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Collect a triggered acquisition.
+  *         Once the wake-up event has occurred and the FIFO is frozen,
+  *         its whole content is read in a single transaction and the
+  *         acquisition is armed again. Call it on the fifo_full
+  *         interrupt or periodically.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  acq    Acquisition state.(ptr)
+  * @param  fdata  Buffer that stores the FIFO words (512 to drain all).
+  * @param  max    Size of fdata in FIFO words.
+  * @param  num    FIFO words read, 0 -> acquisition still in progress.
+  * @retval        Interface status (MANDATORY: return 0 -> no Error),
+  *                -1 also if the acquisition does not fit in fdata: the
+  *                FIFO is left frozen and num is set to the FIFO level,
+  *                so it can be collected again with a larger buffer.
+  *
+  */
+int32_t iis3dwb_trig_acq_collect(const stmdev_ctx_t *ctx,
+                                 iis3dwb_trig_acq_t *acq,
+                                 iis3dwb_fifo_out_raw_t *fdata, uint16_t max,
+                                 uint16_t *num)
+{
+  iis3dwb_all_sources_t src;
+  iis3dwb_fifo_status_t status = {0};
+  int32_t ret = 0;
+
+  *num = 0U;
+
+  if (acq->triggered == 0U)
+  {
+    ret = iis3dwb_all_sources_get(ctx, &src);
+
+    if ((ret == 0) && (src.wake_up_src.wu_ia != 0U))
+    {
+      acq->triggered = 1U;
+      acq->wake_up_src = src.wake_up_src;
+    }
+  }
+
+  if ((ret == 0) && (acq->triggered != 0U))
+  {
+    ret = iis3dwb_fifo_status_get(ctx, &status);
+  }
+
+  if ((ret == 0) && ((status.fifo_full | status.fifo_ovr) != 0U))
+  {
+    *num = status.fifo_level;
+
+    if (status.fifo_level > max)
+    {
+      return -1;
+    }
+
+    ret = iis3dwb_fifo_out_multi_raw_get(ctx, fdata, *num);
+
+    if (ret == 0)
+    {
+      ret = trig_acq_start(ctx, acq);
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_gate Activity Gating
+  * @brief      This section groups the functions that stop the FIFO
+  *             draining while the device detects inactivity.
+  * @{
+  *
+  */
+
+/**
+  * @brief  Initialize the activity gate: set the inactivity duration and
+  *         route the sleep status on INT1 or INT2, keeping the other
+  *         signals routed on that pin. The pin level then follows the
+  *         activity state (high while inactive) and is only read by the
+  *         host, so no latched source register is read or cleared.
+  *         The wake-up threshold must be configured and the FIFO must
+  *         run in STREAM mode. The status mode is shared by both pins,
+  *         so the gate is rejected while the other pin routes
+  *         sleep_change, which would silently become a status level.
+  *
+  * @param  ctx      Read / write interface definitions.(ptr)
+  * @param  gate     Gate state.(ptr)
+  * @param  int_pin  1 -> INT1, 2 -> INT2.
+  * @param  dur      Inactivity duration (1 LSb = 512 / ODR), see
+  *                  iis3dwb_act_sleep_dur_set.
+  * @retval          Interface status (MANDATORY: return 0 -> no Error),
+  *                  -1 also for an invalid pin or sleep_change routed
+  *                  on the other pin.
+  *
+  */
+int32_t iis3dwb_gate_init(const stmdev_ctx_t *ctx, iis3dwb_gate_t *gate,
+                          uint8_t int_pin, uint8_t dur)
+{
+  iis3dwb_pin_int_route_t route;
+  int32_t ret;
+
+  if ((gate == NULL) || ((int_pin != 1U) && (int_pin != 2U)))
+  {
+    return -1;
+  }
+
+  memset(gate, 0, sizeof(iis3dwb_gate_t));
+
+  ret = (int_pin == 1U) ? iis3dwb_pin_int2_route_get(ctx, &route) :
+        iis3dwb_pin_int1_route_get(ctx, &route);
+
+  if ((ret == 0) && (route.sleep_change != 0U))
+  {
+    ret = -1;
+  }
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_act_sleep_dur_set(ctx, dur);
+  }
+
+  if (ret == 0)
+  {
+    ret = (int_pin == 1U) ? iis3dwb_pin_int1_route_get(ctx, &route) :
+          iis3dwb_pin_int2_route_get(ctx, &route);
+  }
+
+  if (ret == 0)
+  {
+    route.sleep_change = PROPERTY_DISABLE;
+    route.sleep_status = PROPERTY_ENABLE;
+    ret = (int_pin == 1U) ? iis3dwb_pin_int1_route_set(ctx, &route) :
+          iis3dwb_pin_int2_route_set(ctx, &route);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Drain the FIFO only while the device detects activity.
+  *         While idle a single output sample (6 bytes) is read as a
+  *         low-rate summary and the FIFO keeps streaming on chip, so on
+  *         the return of activity the first drained words are the
+  *         history preceding it.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  gate   Gate state.(ptr)
+  * @param  sleep  Level of the pin routed by iis3dwb_gate_init,
+  *                1 -> inactivity.
+  * @param  fdata  Buffer that stores the FIFO words.(ptr)
+  * @param  max    Size of fdata in FIFO words.
+  * @param  num    FIFO words read, always 0 while idle.
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_gate_run(const stmdev_ctx_t *ctx, iis3dwb_gate_t *gate,
+                         uint8_t sleep, iis3dwb_fifo_out_raw_t *fdata,
+                         uint16_t max, uint16_t *num)
+{
+  iis3dwb_fifo_status_t status;
+  int32_t ret;
+
+  *num = 0U;
+  gate->resumed = 0U;
+
+  if (sleep != 0U)
+  {
+    gate->idle = 1U;
+    ret = iis3dwb_acceleration_raw_get(ctx, gate->summary);
+  }
+  else
+  {
+    gate->resumed = gate->idle;
+    gate->idle = 0U;
+    ret = iis3dwb_fifo_status_get(ctx, &status);
+
+    if (ret == 0)
+    {
+      *num = (status.fifo_level > max) ? max : status.fifo_level;
+    }
+
+    if ((ret == 0) && (*num > 0U))
+    {
+      ret = iis3dwb_fifo_out_multi_raw_get(ctx, fdata, *num);
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_temp_comp Temperature Compensation
+  * @brief      This section groups the functions that compensate the
+  *             accelerometer offset and sensitivity drift using the
+  *             temperature batched in FIFO.
+  * @{
+  *
+  */
+
+static void temp_comp_update(iis3dwb_temp_comp_t *tc, float_t temp)
+{
+  const float_t dt = temp - tc->t0;
+  uint8_t j;
+
+  tc->temp = temp;
+  for (j = 0U; j < 3U; j++)
+  {
+    tc->gain[j] = tc->sens / (1.0f + (tc->sens_tc[j] * dt));
+    tc->offset[j] = tc->off_tc[j] * dt;
+  }
+}
+
+/**
+  * @brief  Initialize a temperature compensation model:
+  *         mg = lsb * sens / (1 + sens_tc * (T - t0)) - off_tc * (T - t0)
+  *         The model starts at t0 until the first temperature word is
+  *         found in FIFO.
+  *
+  * @param  tc       Compensation state.(ptr)
+  * @param  fs       Accelerometer full scale.
+  * @param  t0       Reference temperature (degC).
+  * @param  off_tc   X, Y, Z offset drift (mg/degC).(ptr)
+  * @param  sens_tc  X, Y, Z relative sensitivity drift (1/degC).(ptr)
+  * @retval          0 -> model ready, -1 -> NULL pointer.
+  *
+  */
+int32_t iis3dwb_temp_comp_init(iis3dwb_temp_comp_t *tc, iis3dwb_fs_xl_t fs,
+                               float_t t0, const float_t *off_tc,
+                               const float_t *sens_tc)
+{
+  uint8_t j;
+
+  if ((tc == NULL) || (off_tc == NULL) || (sens_tc == NULL))
+  {
+    return -1;
+  }
+
+  tc->t0 = t0;
+  tc->sens = xl_mg_per_lsb((uint8_t)fs);
+  for (j = 0U; j < 3U; j++)
+  {
+    tc->off_tc[j] = off_tc[j];
+    tc->sens_tc[j] = sens_tc[j];
+  }
+  temp_comp_update(tc, t0);
+
+  return 0;
+}
+
+/**
+  * @brief  Convert the accelerometer words of a FIFO buffer into
+  *         compensated mg. Temperature words update the model in stream
+  *         order, so the correction costs one multiply-add per sample
+  *         component on top of the plain conversion.
+  *
+  * @param  tc     Compensation state.(ptr)
+  * @param  fdata  FIFO words read by iis3dwb_fifo_out_multi_raw_get.(ptr)
+  * @param  num    Number of FIFO words.
+  * @param  mg     Buffer that stores X, Y, Z of each sample (3 * num).
+  * @retval        Number of accelerometer samples converted.
+  *
+  */
+uint16_t iis3dwb_fifo_xl_comp_to_mg(iis3dwb_temp_comp_t *tc,
+                                    const iis3dwb_fifo_out_raw_t *fdata,
+                                    uint16_t num, float_t *mg)
+{
+  uint16_t cnt = 0U;
+  uint16_t i;
+  int16_t lsb;
+  uint8_t tag;
+  uint8_t j;
+
+  for (i = 0U; i < num; i++)
+  {
+    tag = IIS3DWB_FIELD_GET(IIS3DWB_FIFO_DATA_OUT_TAG_TAG_SENSOR,
+                            fdata[i].tag);
+
+    if (tag == (uint8_t)IIS3DWB_XL_TAG)
+    {
+      for (j = 0U; j < 3U; j++)
+      {
+        lsb = (int16_t)fdata[i].data[(2U * j) + 1U];
+        lsb = (lsb * 256) + (int16_t)fdata[i].data[2U * j];
+        mg[(3U * cnt) + j] = ((float_t)lsb * tc->gain[j]) - tc->offset[j];
+      }
+      cnt++;
+    }
+    else if (tag == (uint8_t)IIS3DWB_TEMPERATURE_TAG)
+    {
+      lsb = (int16_t)fdata[i].data[1];
+      lsb = (lsb * 256) + (int16_t)fdata[i].data[0];
+      temp_comp_update(tc, iis3dwb_from_lsb_to_celsius(lsb));
+    }
+    else
+    {
+      /* timestamp words carry no acceleration */
+    }
+  }
+
+  return cnt;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_fifo_dec FIFO Stream Decoder
+  * @brief      This section groups the functions that decode FIFO words
+  *             into timestamped samples, also in single axis modes.
+  * @{
+  *
+  */
+
+/* 26.667 kHz typical accelerometer ODR */
+#define XL_PERIOD_NS                         37500U
+#define TIMESTAMP_LSB_NS                     25000U
+
+/**
+  * @brief  Initialize a FIFO stream decoder.
+  *         In IIS3DWB_ONLY_x_ON_ALL_OUT_REG modes every FIFO word holds
+  *         three consecutive samples of the selected axis (oldest in the
+  *         X slot), in IIS3DWB_ONLY_x_ON_ONE_OUT_REG modes one sample;
+  *         otherwise one X, Y, Z sample. period_ns may be adjusted
+  *         to the actual ODR after the initialization.
+  *
+  * @param  dec       Decoder state.(ptr)
+  * @param  axis_sel  Axis selection the data was batched with.
+  * @retval           0 -> decoder ready, -1 -> NULL pointer.
+  *
+  */
+int32_t iis3dwb_fifo_dec_init(iis3dwb_fifo_dec_t *dec,
+                              iis3dwb_xl_axis_sel_t axis_sel)
+{
+  if (dec == NULL)
+  {
+    return -1;
+  }
+
+  memset(dec, 0, sizeof(iis3dwb_fifo_dec_t));
+  dec->axis_sel = axis_sel;
+  dec->period_ns = XL_PERIOD_NS;
+
+  return 0;
+}
+
+/**
+  * @brief  Number of xl elements of each decoded sample.
+  *
+  * @param  dec    Decoder state.(ptr)
+  * @retval        3 -> X, Y, Z samples, 1 -> single axis samples.
+  *
+  */
+uint8_t iis3dwb_fifo_dec_stride(const iis3dwb_fifo_dec_t *dec)
+{
+  return (((uint8_t)dec->axis_sel & 0x03U) != 0U) ? 1U : 3U;
+}
+
+/**
+  * @brief  Decode a FIFO buffer into samples and their timestamps.
+  *         Timestamp words (if batched) realign the time of the next
+  *         samples, the 32-bit counter wrap is extended to 64 bits;
+  *         between them the time advances by period_ns per sample.
+  *
+  * @param  dec    Decoder state.(ptr)
+  * @param  fdata  FIFO words read by iis3dwb_fifo_out_multi_raw_get.(ptr)
+  * @param  num    Number of FIFO words.
+  * @param  xl     Buffer that stores the samples, stride elements each
+  *                (up to 3 * num elements).
+  * @param  ts_ns  Buffer that stores the time of each sample (ns),
+  *                NULL if not needed.
+  * @retval        Number of samples decoded.
+  *
+  */
+uint16_t iis3dwb_fifo_dec_run(iis3dwb_fifo_dec_t *dec,
+                              const iis3dwb_fifo_out_raw_t *fdata,
+                              uint16_t num, int16_t *xl, uint64_t *ts_ns)
+{
+  const uint8_t axis = (uint8_t)dec->axis_sel & 0x03U;
+  const uint8_t stride = iis3dwb_fifo_dec_stride(dec);
+  uint32_t raw;
+  uint16_t cnt = 0U;
+  uint16_t idx;
+  uint16_t i;
+  uint8_t first;
+  uint8_t last;
+  uint8_t tag;
+  uint8_t j;
+
+  /* data slots of each word: X, Y, Z of one sample, three samples of
+   * one axis or a single sample of one axis
+   */
+  if ((axis == 0U) || (((uint8_t)dec->axis_sel & 0x10U) != 0U))
+  {
+    first = 0U;
+    last = 2U;
+  }
+  else
+  {
+    first = axis - 1U;
+    last = axis - 1U;
+  }
+
+  for (i = 0U; i < num; i++)
+  {
+    tag = IIS3DWB_FIELD_GET(IIS3DWB_FIFO_DATA_OUT_TAG_TAG_SENSOR,
+                            fdata[i].tag);
+
+    if (tag == (uint8_t)IIS3DWB_TIMESTAMP_TAG)
+    {
+      raw = fdata[i].data[3];
+      raw = (raw * 256U) + fdata[i].data[2];
+      raw = (raw * 256U) + fdata[i].data[1];
+      raw = (raw * 256U) + fdata[i].data[0];
+
+      if ((dec->ts_valid != 0U) && (raw < dec->ts_raw))
+      {
+        dec->ts_wraps++;
+      }
+      dec->ts_raw = raw;
+      dec->ts_valid = 1U;
+      dec->ts_ns = (((uint64_t)dec->ts_wraps << 32) + raw) * TIMESTAMP_LSB_NS;
+    }
+    else if (tag == (uint8_t)IIS3DWB_XL_TAG)
+    {
+      for (j = first; j <= last; j++)
+      {
+        idx = (stride == 1U) ? cnt : ((3U * cnt) + j);
+        xl[idx] = (int16_t)fdata[i].data[(2U * j) + 1U];
+        xl[idx] = (xl[idx] * 256) + (int16_t)fdata[i].data[2U * j];
+
+        if ((stride == 1U) || (j == last))
+        {
+          if (ts_ns != NULL)
+          {
+            ts_ns[cnt] = dec->ts_ns;
+          }
+          dec->ts_ns += dec->period_ns;
+          cnt++;
+        }
+      }
+    }
+    else
+    {
+      /* temperature words are not decoded here */
+    }
+  }
+
+  return cnt;
+}
+
+/**
+  * @brief  Convert a block of raw samples (any axis layout) into mg.
+  *
+  * @param  fs     Accelerometer full scale.
+  * @param  lsb    Raw samples.(ptr)
+  * @param  num    Number of elements.
+  * @param  mg     Buffer that stores the converted elements.(ptr)
+  *
+  */
+void iis3dwb_xl_block_to_mg(iis3dwb_fs_xl_t fs, const int16_t *lsb,
+                            uint32_t num, float_t *mg)
+{
+  const float_t sens = xl_mg_per_lsb((uint8_t)fs);
+  uint32_t i;
+
+  for (i = 0U; i < num; i++)
+  {
+    mg[i] = (float_t)lsb[i] * sens;
+  }
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_latency Latency Histogram
+  * @brief      This section groups the functions that collect latency
+  *             distributions in logarithmic buckets of host timer ticks.
+  * @{
+  *
+  */
+
+/**
+  * @brief  Clear a latency histogram.
+  *
+  * @param  hist   Latency histogram.(ptr)
+  *
+  */
+void iis3dwb_lat_hist_reset(iis3dwb_lat_hist_t *hist)
+{
+  memset(hist, 0, sizeof(iis3dwb_lat_hist_t));
+  hist->min = 0xFFFFFFFFU;
+}
+
+/**
+  * @brief  Add a latency to a histogram.
+  *
+  * @param  hist   Latency histogram.(ptr)
+  * @param  ticks  Latency in host timer ticks.
+  *
+  */
+void iis3dwb_lat_hist_add(iis3dwb_lat_hist_t *hist, uint32_t ticks)
+{
+  uint32_t val = ticks;
+  uint8_t k = 0U;
+
+  while (val != 0U)
+  {
+    val >>= 1;
+    k++;
+  }
+
+  hist->bucket[k]++;
+  hist->count++;
+  hist->min = (ticks < hist->min) ? ticks : hist->min;
+  hist->max = (ticks > hist->max) ? ticks : hist->max;
+}
+
+/**
+  * @brief  Latency percentile of a histogram.
+  *
+  * @param  hist   Latency histogram.(ptr)
+  * @param  pct    Percentile (0 .. 100).
+  * @retval        Upper bound (ticks) of the bucket holding the
+  *                percentile, never above the maximum latency.
+  *
+  */
+uint32_t iis3dwb_lat_hist_percentile(const iis3dwb_lat_hist_t *hist,
+                                     uint8_t pct)
+{
+  const uint64_t target = (((uint64_t)hist->count * pct) + 99U) / 100U;
+  uint64_t cum = 0U;
+  uint32_t upper = 0U;
+  uint8_t k;
+
+  for (k = 0U; (k < IIS3DWB_LAT_HIST_BUCKETS) && (cum < target); k++)
+  {
+    cum += hist->bucket[k];
+    upper = (k == 0U) ? 0U : ((uint32_t)(((uint64_t)1U << k) - 1U));
+  }
+
+  return (upper > hist->max) ? hist->max : upper;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_poll Low Latency Polling
+  * @brief      This section groups the functions that deliver the newest
+  *             output sample with one bus transaction per poll.
+  * @{
+  *
+  */
+
+/**
+  * @brief  Initialize a low latency polling loop.
+  *
+  * @param  poll    Polling state.(ptr)
+  * @param  tick    Free running host timer, the poll interval unit.
+  * @param  sample  Callback receiving each new X, Y, Z sample.
+  * @param  arg     Argument passed to the callback.
+  * @retval         0 -> ready, -1 -> NULL pointer.
+  *
+  */
+int32_t iis3dwb_poll_init(iis3dwb_poll_t *poll, iis3dwb_tick_ptr tick,
+                          iis3dwb_sample_cb_t sample, void *arg)
+{
+  if ((poll == NULL) || (tick == NULL) || (sample == NULL))
+  {
+    return -1;
+  }
+
+  poll->tick = tick;
+  poll->sample = sample;
+  poll->arg = arg;
+  iis3dwb_lat_hist_reset(&poll->hist);
+
+  return 0;
+}
+
+/**
+  * @brief  Poll the device for new samples.
+  *         Each poll reads STATUS_REG (1Eh) to OUTZ_H_A (2Dh) in a single
+  *         16 byte transaction, so a new sample costs no second access.
+  *         The value passed to the callback and added to the histogram
+  *         is the poll interval, from the start of the previous poll of
+  *         the same call to the delivery: the upper bound of the sample
+  *         age, not the end-to-end latency. The first poll of each call
+  *         has no previous poll, the sample it may find has an unknown
+  *         age and is discarded, so num must be greater than 1.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  poll   Polling state.(ptr)
+  * @param  num    Number of polls.
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_poll_run(const stmdev_ctx_t *ctx, iis3dwb_poll_t *poll,
+                         uint32_t num)
+{
+  iis3dwb_status_reg_t status_reg;
+  uint8_t buff[16];
+  int16_t xl[3];
+  uint32_t prev = 0U;
+  uint32_t start;
+  uint32_t lat;
+  uint32_t i;
+  uint8_t j;
+  int32_t ret = 0;
+
+  for (i = 0U; (ret == 0) && (i < num); i++)
+  {
+    start = poll->tick();
+    ret = iis3dwb_read_reg(ctx, IIS3DWB_STATUS_REG, buff, 16);
+    bytecpy((uint8_t *)&status_reg, &buff[0]);
+
+    if ((ret == 0) && (i > 0U) && (status_reg.xlda != 0U))
+    {
+      for (j = 0U; j < 3U; j++)
+      {
+        xl[j] = (int16_t)buff[(IIS3DWB_OUTX_H_A - IIS3DWB_STATUS_REG) + (2U * j)];
+        xl[j] = (xl[j] * 256) +
+                (int16_t)buff[(IIS3DWB_OUTX_L_A - IIS3DWB_STATUS_REG) + (2U * j)];
+      }
+
+      lat = poll->tick() - prev;
+      iis3dwb_lat_hist_add(&poll->hist, lat);
+      poll->sample(poll->arg, xl, lat);
+    }
+
+    prev = start;
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_drdy Data-Ready Sample Path
+  * @brief      This section groups the functions that deliver each sample
+  *             from the pulsed data-ready interrupt.
+  * @{
+  *
+  */
+
+/**
+  * @brief  Start the data-ready sample path: pulsed data-ready, drdy_xl
+  *         routed on INT1 (other INT1 routes are kept) and latency
+  *         histogram cleared.
+  *
+  * @param  ctx     Read / write interface definitions.(ptr)
+  * @param  drdy    Data-ready path state.(ptr)
+  * @param  tick    Free running host timer, the latency unit.
+  * @param  sample  Callback receiving each X, Y, Z sample.
+  * @param  arg     Argument passed to the callback.
+  * @retval         Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_drdy_start(const stmdev_ctx_t *ctx, iis3dwb_drdy_t *drdy,
+                           iis3dwb_tick_ptr tick, iis3dwb_sample_cb_t sample,
+                           void *arg)
+{
+  iis3dwb_pin_int_route_t route;
+  int32_t ret;
+
+  if ((drdy == NULL) || (tick == NULL) || (sample == NULL))
+  {
+    return -1;
+  }
+
+  drdy->tick = tick;
+  drdy->sample = sample;
+  drdy->arg = arg;
+  iis3dwb_lat_hist_reset(&drdy->hist);
+
+  ret = iis3dwb_data_ready_mode_set(ctx, IIS3DWB_DRDY_PULSED);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_pin_int1_route_get(ctx, &route);
+  }
+
+  if (ret == 0)
+  {
+    route.drdy_xl = PROPERTY_ENABLE;
+    ret = iis3dwb_pin_int1_route_set(ctx, &route);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Data-ready interrupt handler: read the sample with a single
+  *         6 byte transaction, pass it to the callback and add the
+  *         interrupt to callback latency to the histogram.
+  *
+  * @param  ctx       Read / write interface definitions.(ptr)
+  * @param  drdy      Data-ready path state.(ptr)
+  * @param  irq_tick  Host timer value at interrupt entry.
+  * @retval           Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_drdy_irq(const stmdev_ctx_t *ctx, iis3dwb_drdy_t *drdy,
+                         uint32_t irq_tick)
+{
+  int16_t xl[3];
+  uint32_t lat;
+
+  const int32_t ret = iis3dwb_acceleration_raw_get(ctx, xl);
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  lat = drdy->tick() - irq_tick;
+  drdy->sample(drdy->arg, xl, lat);
+  iis3dwb_lat_hist_add(&drdy->hist, lat);
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_framer Fixed Size Framing
+  * @brief      This section groups the functions that deliver the FIFO
+  *             content in frames of a fixed number of samples, paced by
+  *             the batch counter interrupt.
+  * @{
+  *
+  */
+
+/*
+ * Decode the accelerometer words read in buf into X, Y, Z samples at the
+ * start of the same buffer: sample n (6 bytes) never overlaps the words
+ * still to be decoded, which start at byte 7 * (n + 1).
+ */
+static uint16_t fifo_xl_decode_in_place(int16_t *buf, uint16_t num)
+{
+  const uint8_t *raw = (const uint8_t *)buf;
+  uint8_t word[7];
+  uint16_t cnt = 0U;
+  uint16_t i;
+  uint8_t j;
+
+  for (i = 0U; i < num; i++)
+  {
+    memcpy(word, &raw[7U * i], 7U);
+
+    if (IIS3DWB_FIELD_GET(IIS3DWB_FIFO_DATA_OUT_TAG_TAG_SENSOR,
+                          word[0]) == (uint8_t)IIS3DWB_XL_TAG)
+    {
+      for (j = 0U; j < 3U; j++)
+      {
+        buf[(3U * cnt) + j] = (int16_t)word[(2U * j) + 2U];
+        buf[(3U * cnt) + j] = (buf[(3U * cnt) + j] * 256) +
+                              (int16_t)word[(2U * j) + 1U];
+      }
+      cnt++;
+    }
+  }
+
+  return cnt;
+}
+
+static int32_t framer_sync(const stmdev_ctx_t *ctx)
+{
+  /* empty the FIFO and restart the batch counter together */
+  int32_t ret = iis3dwb_fifo_mode_set(ctx, IIS3DWB_BYPASS_MODE);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_rst_batch_counter_set(ctx, PROPERTY_ENABLE);
+  }
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_fifo_mode_set(ctx, IIS3DWB_STREAM_MODE);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Start fixed size framing.
+  *         The batch counter threshold is set to len and fifo_bdr is
+  *         routed on INT1 (other INT1 routes are kept); the FIFO is
+  *         restarted in STREAM mode. Only the accelerometer may be
+  *         batched, so each frame holds exactly len X, Y, Z samples.
+  *
+  * @param  ctx     Read / write interface definitions.(ptr)
+  * @param  fr      Framer state.(ptr)
+  * @param  frames  Frame buffers, IIS3DWB_FRAME_BUF_LEN(len) elements each.
+  * @param  num     Number of frame buffers, used in turn.
+  * @param  len     Samples per frame (1 .. 512).
+  * @param  frame   Callback receiving each frame.
+  * @param  arg     Argument passed to the callback.
+  * @retval         Interface status (MANDATORY: return 0 -> no Error),
+  *                 -1 also for invalid arguments or FIFO batching.
+  *
+  */
+int32_t iis3dwb_framer_start(const stmdev_ctx_t *ctx, iis3dwb_framer_t *fr,
+                             int16_t *const *frames, uint8_t num,
+                             uint16_t len, iis3dwb_frame_cb_t frame,
+                             void *arg)
+{
+  iis3dwb_pin_int_route_t route;
+  uint8_t buff[2];
+  int32_t ret;
+
+  if ((fr == NULL) || (frames == NULL) || (num == 0U) || (len == 0U) ||
+      (len > 512U) || (frame == NULL))
+  {
+    return -1;
+  }
+
+  fr->frames = frames;
+  fr->num = num;
+  fr->next = 0U;
+  fr->len = len;
+  fr->frame = frame;
+  fr->arg = arg;
+
+  ret = iis3dwb_read_reg(ctx, IIS3DWB_FIFO_CTRL3, buff, 2);
+  if (ret != 0)
+  {
+    return ret;
+  }
+
+  if ((IIS3DWB_FIELD_GET(IIS3DWB_FIFO_CTRL3_BDR_XL, buff[0]) == 0U) ||
+      (IIS3DWB_FIELD_GET(IIS3DWB_FIFO_CTRL4_ODR_T_BATCH, buff[1]) != 0U) ||
+      (IIS3DWB_FIELD_GET(IIS3DWB_FIFO_CTRL4_ODR_TS_BATCH, buff[1]) != 0U))
+  {
+    return -1;
+  }
+
+  ret = iis3dwb_batch_counter_threshold_set(ctx, len);
+
+  if (ret == 0)
+  {
+    ret = iis3dwb_pin_int1_route_get(ctx, &route);
+  }
+
+  if (ret == 0)
+  {
+    route.fifo_bdr = PROPERTY_ENABLE;
+    ret = iis3dwb_pin_int1_route_set(ctx, &route);
+  }
+
+  if (ret == 0)
+  {
+    ret = framer_sync(ctx);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Batch counter interrupt handler: every complete frame in FIFO
+  *         is read with one transaction straight into the next frame
+  *         buffer and decoded in place. After a FIFO overrun, or if a
+  *         frame holds words other than accelerometer samples (e.g.
+  *         batching changed after iis3dwb_framer_start), the FIFO and
+  *         the batch counter are restarted and the data is dropped.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  fr     Framer state.(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_framer_irq(const stmdev_ctx_t *ctx, iis3dwb_framer_t *fr)
+{
+  iis3dwb_fifo_status_t status;
+  int16_t *xl;
+  uint16_t level = 0U;
+
+  int32_t ret = iis3dwb_fifo_status_get(ctx, &status);
+
+  if ((ret == 0) && (status.fifo_ovr != 0U))
+  {
+    ret = framer_sync(ctx);
+  }
+  else
+  {
+    level = status.fifo_level;
+  }
+
+  while ((ret == 0) && (level >= fr->len))
+  {
+    xl = fr->frames[fr->next];
+    ret = iis3dwb_read_reg(ctx, IIS3DWB_FIFO_DATA_OUT_TAG, (uint8_t *)xl,
+                           (uint16_t)(7U * fr->len));
+
+    if ((ret == 0) && (fifo_xl_decode_in_place(xl, fr->len) != fr->len))
+    {
+      /* frame tail not decoded: realign instead of delivering it */
+      ret = framer_sync(ctx);
+      level = 0U;
+    }
+    else if (ret == 0)
+    {
+      fr->next = ((fr->next + 1U) < fr->num) ? (fr->next + 1U) : 0U;
+      level -= fr->len;
+      fr->frame(fr->arg, xl, fr->len);
+    }
+    else
+    {
+      /* interface error, the loop ends */
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup   IIS3DWB_ring Multi-Consumer Sample Ring
+  * @brief      This section groups the functions that publish decoded FIFO
+  *             blocks in a single producer, multiple consumer ring.
+  *             The ring holds no pointers, so it can be placed in memory
+  *             shared between processes and read in place by each
+  *             consumer through its own cursor.
+  * @{
+  *
+  */
+
+static int16_t *ring_slot(const iis3dwb_ring_t *ring, uint32_t idx)
+{
+  /* slots follow the ring header */
+  int16_t *base = (int16_t *)(uintptr_t)&ring[1];
+
+  return &base[(idx % ring->blocks) * IIS3DWB_RING_SLOT_LEN(ring->block_len)];
+}
+
+/**
+  * @brief  Initialize a sample ring.
+  *
+  * @param  ring       Ring memory of IIS3DWB_RING_SIZE(blocks, block_len)
+  *                    bytes, 4 bytes aligned.(ptr)
+  * @param  blocks     Number of blocks (> 1).
+  * @param  block_len  Max samples per block (1 .. 512).
+  * @retval            0 -> ring ready, -1 -> invalid arguments.
+  *
+  */
+int32_t iis3dwb_ring_init(iis3dwb_ring_t *ring, uint16_t blocks,
+                          uint16_t block_len)
+{
+  if ((ring == NULL) || (blocks < 2U) || (block_len == 0U) ||
+      (block_len > 512U))
+  {
+    return -1;
+  }
+
+  memset(ring, 0, IIS3DWB_RING_SIZE(blocks, block_len));
+  ring->blocks = blocks;
+  ring->block_len = block_len;
+
+  return 0;
+}
+
+/**
+  * @brief  Producer: read up to block_len FIFO words with one transaction
+  *         straight into the next slot, decode the accelerometer samples
+  *         in place and publish them as a new block.
+  *
+  * @param  ctx    Read / write interface definitions.(ptr)
+  * @param  ring   Sample ring.(ptr)
+  * @param  num    Samples published (0 -> FIFO empty).(ptr)
+  * @retval        Interface status (MANDATORY: return 0 -> no Error).
+  *
+  */
+int32_t iis3dwb_ring_fifo_publish(const stmdev_ctx_t *ctx,
+                                  iis3dwb_ring_t *ring, uint16_t *num)
+{
+  iis3dwb_fifo_status_t status = {0};
+  int16_t *slot = ring_slot(ring, ring->head);
+  uint16_t len;
+  int32_t ret;
+
+  *num = 0U;
+
+  ret = iis3dwb_fifo_status_get(ctx, &status);
+  len = (status.fifo_level > ring->block_len) ? ring->block_len :
+        status.fifo_level;
+
+  if ((ret == 0) && (len > 0U))
+  {
+    ret = iis3dwb_read_reg(ctx, IIS3DWB_FIFO_DATA_OUT_TAG,
+                           (uint8_t *)&slot[2], (uint16_t)(7U * len));
+  }
+
+  if ((ret == 0) && (len > 0U))
+  {
+    *num = fifo_xl_decode_in_place(&slot[2], len);
+    slot[0] = (int16_t)*num;
+
+    /* the head update is visible before the next slot is overwritten,
+     * so a consumer still reading it detects the overwrite
+     */
+    if (*num > 0U)
+    {
+      IIS3DWB_RING_BARRIER();
+      ring->head++;
+      IIS3DWB_RING_BARRIER();
+    }
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Consumer: start reading from the next published block.
+  *
+  * @param  ring   Sample ring.(ptr)
+  * @param  cur    Consumer cursor.(ptr)
+  *
+  */
+void iis3dwb_ring_cursor_init(const iis3dwb_ring_t *ring,
+                              iis3dwb_ring_cursor_t *cur)
+{
+  cur->tail = ring->head;
+  cur->lost = 0U;
+}
+
+/**
+  * @brief  Consumer: access the oldest unread block in place.
+  *         A consumer lagging more than the ring length skips to the
+  *         oldest block still available and counts the lost ones.
+  *
+  * @param  ring   Sample ring.(ptr)
+  * @param  cur    Consumer cursor.(ptr)
+  * @param  num    Samples of the block.(ptr)
+  * @retval        X, Y, Z samples of the block, NULL -> no new block.
+  *
+  */
+const int16_t *iis3dwb_ring_peek(const iis3dwb_ring_t *ring,
+                                 iis3dwb_ring_cursor_t *cur, uint16_t *num)
+{
+  const uint32_t head = ring->head;
+  const int16_t *slot;
+
+  *num = 0U;
+
+  if (head == cur->tail)
+  {
+    return NULL;
+  }
+
+  if ((head - cur->tail) >= ring->blocks)
+  {
+    cur->lost += (head - cur->tail) - (ring->blocks - 1U);
+    cur->tail = head - (ring->blocks - 1U);
+  }
+
+  IIS3DWB_RING_BARRIER();
+  slot = ring_slot(ring, cur->tail);
+  *num = (uint16_t)slot[0];
+
+  return &slot[2];
+}
+
+/**
+  * @brief  Consumer: release the block returned by iis3dwb_ring_peek.
+  *
+  * @param  ring   Sample ring.(ptr)
+  * @param  cur    Consumer cursor.(ptr)
+  * @retval        0 -> block was intact while being read,
+  *                -1 -> the producer overwrote it (counted as lost).
+  *
+  */
+int32_t iis3dwb_ring_advance(const iis3dwb_ring_t *ring,
+                             iis3dwb_ring_cursor_t *cur)
+{
+  int32_t ret = 0;
+
+  IIS3DWB_RING_BARRIER();
+  if ((ring->head - cur->tail) >= ring->blocks)
+  {
+    cur->lost++;
+    ret = -1;
+  }
+  cur->tail++;
+
+  return ret;
+}
+
+/**
+  * @}
+  *
+  */
@@ -739,6 +739,229 @@ typedef union
   uint8_t                                 byte;
 } iis3dwb_reg_t;
 
+/**
+  * @}
+  *
+  */
+
+/**
+  * @defgroup IIS3DWB_Register_Fields
+  * @brief    Position and mask of each register field.
+  *           Unlike the bit-field structures above they do not depend on
+  *           DRV_BYTE_ORDER or on the compiler bit-field layout, and
+  *           IIS3DWB_FIELD_PREP / IIS3DWB_FIELD_GET fold into constants
+  *           when the field value is known at compile time. Several
+  *           fields of the same register can be OR-ed together and
+  *           updated with a single iis3dwb_reg_bits_set call.
+  *
+  * @{
+  *
+  */
+
+#define IIS3DWB_FIELD_PREP(field, val) \
+  ((uint8_t)(((uint32_t)(val) << field##_POS) & field##_MSK))
+#define IIS3DWB_FIELD_GET(field, reg) \
+  ((uint8_t)(((uint32_t)(reg) & field##_MSK) >> field##_POS))
+
+#define IIS3DWB_PIN_CTRL_SDO_PU_EN_POS           6U
+#define IIS3DWB_PIN_CTRL_SDO_PU_EN_MSK           0x40U
+
+#define IIS3DWB_FIFO_CTRL1_WTM_POS               0U
+#define IIS3DWB_FIFO_CTRL1_WTM_MSK               0xFFU
+
+#define IIS3DWB_FIFO_CTRL2_WTM_POS               0U
+#define IIS3DWB_FIFO_CTRL2_WTM_MSK               0x01U
+#define IIS3DWB_FIFO_CTRL2_STOP_ON_WTM_POS       7U
+#define IIS3DWB_FIFO_CTRL2_STOP_ON_WTM_MSK       0x80U
+
+#define IIS3DWB_FIFO_CTRL3_BDR_XL_POS            0U
+#define IIS3DWB_FIFO_CTRL3_BDR_XL_MSK            0x0FU
+
+#define IIS3DWB_FIFO_CTRL4_FIFO_MODE_POS         0U
+#define IIS3DWB_FIFO_CTRL4_FIFO_MODE_MSK         0x07U
+#define IIS3DWB_FIFO_CTRL4_ODR_T_BATCH_POS       4U
+#define IIS3DWB_FIFO_CTRL4_ODR_T_BATCH_MSK       0x30U
+#define IIS3DWB_FIFO_CTRL4_ODR_TS_BATCH_POS      6U
+#define IIS3DWB_FIFO_CTRL4_ODR_TS_BATCH_MSK      0xC0U
+
+#define IIS3DWB_COUNTER_BDR_REG1_CNT_BDR_TH_POS  0U
+#define IIS3DWB_COUNTER_BDR_REG1_CNT_BDR_TH_MSK  0x07U
+#define IIS3DWB_COUNTER_BDR_REG1_RST_COUNTER_BDR_POS 6U
+#define IIS3DWB_COUNTER_BDR_REG1_RST_COUNTER_BDR_MSK 0x40U
+#define IIS3DWB_COUNTER_BDR_REG1_DATAREADY_PULSED_POS 7U
+#define IIS3DWB_COUNTER_BDR_REG1_DATAREADY_PULSED_MSK 0x80U
+
+#define IIS3DWB_COUNTER_BDR_REG2_CNT_BDR_TH_POS  0U
+#define IIS3DWB_COUNTER_BDR_REG2_CNT_BDR_TH_MSK  0xFFU
+
+#define IIS3DWB_INT1_CTRL_INT1_DRDY_XL_POS       0U
+#define IIS3DWB_INT1_CTRL_INT1_DRDY_XL_MSK       0x01U
+#define IIS3DWB_INT1_CTRL_INT1_BOOT_POS          2U
+#define IIS3DWB_INT1_CTRL_INT1_BOOT_MSK          0x04U
+#define IIS3DWB_INT1_CTRL_INT1_FIFO_TH_POS       3U
+#define IIS3DWB_INT1_CTRL_INT1_FIFO_TH_MSK       0x08U
+#define IIS3DWB_INT1_CTRL_INT1_FIFO_OVR_POS      4U
+#define IIS3DWB_INT1_CTRL_INT1_FIFO_OVR_MSK      0x10U
+#define IIS3DWB_INT1_CTRL_INT1_FIFO_FULL_POS     5U
+#define IIS3DWB_INT1_CTRL_INT1_FIFO_FULL_MSK     0x20U
+#define IIS3DWB_INT1_CTRL_INT1_CNT_BDR_POS       6U
+#define IIS3DWB_INT1_CTRL_INT1_CNT_BDR_MSK       0x40U
+
+#define IIS3DWB_INT2_CTRL_INT2_DRDY_XL_POS       0U
+#define IIS3DWB_INT2_CTRL_INT2_DRDY_XL_MSK       0x01U
+#define IIS3DWB_INT2_CTRL_INT2_DRDY_TEMP_POS     2U
+#define IIS3DWB_INT2_CTRL_INT2_DRDY_TEMP_MSK     0x04U
+#define IIS3DWB_INT2_CTRL_INT2_FIFO_TH_POS       3U
+#define IIS3DWB_INT2_CTRL_INT2_FIFO_TH_MSK       0x08U
+#define IIS3DWB_INT2_CTRL_INT2_FIFO_OVR_POS      4U
+#define IIS3DWB_INT2_CTRL_INT2_FIFO_OVR_MSK      0x10U
+#define IIS3DWB_INT2_CTRL_INT2_FIFO_FULL_POS     5U
+#define IIS3DWB_INT2_CTRL_INT2_FIFO_FULL_MSK     0x20U
+#define IIS3DWB_INT2_CTRL_INT2_CNT_BDR_POS       6U
+#define IIS3DWB_INT2_CTRL_INT2_CNT_BDR_MSK       0x40U
+
+#define IIS3DWB_CTRL1_XL_LPF2_XL_EN_POS          1U
+#define IIS3DWB_CTRL1_XL_LPF2_XL_EN_MSK          0x02U
+#define IIS3DWB_CTRL1_XL_FS_XL_POS               2U
+#define IIS3DWB_CTRL1_XL_FS_XL_MSK               0x0CU
+#define IIS3DWB_CTRL1_XL_XL_EN_POS               5U
+#define IIS3DWB_CTRL1_XL_XL_EN_MSK               0xE0U
+
+#define IIS3DWB_CTRL3_C_SW_RESET_POS             0U
+#define IIS3DWB_CTRL3_C_SW_RESET_MSK             0x01U
+#define IIS3DWB_CTRL3_C_IF_INC_POS               2U
+#define IIS3DWB_CTRL3_C_IF_INC_MSK               0x04U
+#define IIS3DWB_CTRL3_C_SIM_POS                  3U
+#define IIS3DWB_CTRL3_C_SIM_MSK                  0x08U
+#define IIS3DWB_CTRL3_C_PP_OD_POS                4U
+#define IIS3DWB_CTRL3_C_PP_OD_MSK                0x10U
+#define IIS3DWB_CTRL3_C_H_LACTIVE_POS            5U
+#define IIS3DWB_CTRL3_C_H_LACTIVE_MSK            0x20U
+#define IIS3DWB_CTRL3_C_BDU_POS                  6U
+#define IIS3DWB_CTRL3_C_BDU_MSK                  0x40U
+#define IIS3DWB_CTRL3_C_BOOT_POS                 7U
+#define IIS3DWB_CTRL3_C_BOOT_MSK                 0x80U
+
+#define IIS3DWB_CTRL4_C_1AX_TO_3REGOUT_POS       0U
+#define IIS3DWB_CTRL4_C_1AX_TO_3REGOUT_MSK       0x01U
+#define IIS3DWB_CTRL4_C_LPF1_SEL_G_POS           1U
+#define IIS3DWB_CTRL4_C_LPF1_SEL_G_MSK           0x02U
+#define IIS3DWB_CTRL4_C_I2C_DISABLE_POS          2U
+#define IIS3DWB_CTRL4_C_I2C_DISABLE_MSK          0x04U
+#define IIS3DWB_CTRL4_C_DRDY_MASK_POS            3U
+#define IIS3DWB_CTRL4_C_DRDY_MASK_MSK            0x08U
+#define IIS3DWB_CTRL4_C_INT2_ON_INT1_POS         5U
+#define IIS3DWB_CTRL4_C_INT2_ON_INT1_MSK         0x20U
+
+#define IIS3DWB_CTRL5_C_ST_XL_POS                0U
+#define IIS3DWB_CTRL5_C_ST_XL_MSK                0x03U
+#define IIS3DWB_CTRL5_C_ROUNDING_POS             5U
+#define IIS3DWB_CTRL5_C_ROUNDING_MSK             0x60U
+
+#define IIS3DWB_CTRL6_C_XL_AXIS_SEL_POS          0U
+#define IIS3DWB_CTRL6_C_XL_AXIS_SEL_MSK          0x03U
+#define IIS3DWB_CTRL6_C_USR_OFF_W_POS            3U
+#define IIS3DWB_CTRL6_C_USR_OFF_W_MSK            0x08U
+
+#define IIS3DWB_CTRL7_C_USR_OFF_ON_OUT_POS       1U
+#define IIS3DWB_CTRL7_C_USR_OFF_ON_OUT_MSK       0x02U
+
+#define IIS3DWB_CTRL8_XL_FDS_POS                 2U
+#define IIS3DWB_CTRL8_XL_FDS_MSK                 0x04U
+#define IIS3DWB_CTRL8_XL_FASTSETTL_MODE_XL_POS   3U
+#define IIS3DWB_CTRL8_XL_FASTSETTL_MODE_XL_MSK   0x08U
+#define IIS3DWB_CTRL8_XL_HP_REF_MODE_XL_POS      4U
+#define IIS3DWB_CTRL8_XL_HP_REF_MODE_XL_MSK      0x10U
+#define IIS3DWB_CTRL8_XL_HPCF_XL_POS             5U
+#define IIS3DWB_CTRL8_XL_HPCF_XL_MSK             0xE0U
+
+#define IIS3DWB_CTRL10_C_TIMESTAMP_EN_POS        5U
+#define IIS3DWB_CTRL10_C_TIMESTAMP_EN_MSK        0x20U
+
+#define IIS3DWB_ALL_INT_SRC_WU_IA_POS            1U
+#define IIS3DWB_ALL_INT_SRC_WU_IA_MSK            0x02U
+#define IIS3DWB_ALL_INT_SRC_SLEEP_CHANGE_POS     5U
+#define IIS3DWB_ALL_INT_SRC_SLEEP_CHANGE_MSK     0x20U
+#define IIS3DWB_ALL_INT_SRC_TIMESTAMP_ENDCOUNT_POS 7U
+#define IIS3DWB_ALL_INT_SRC_TIMESTAMP_ENDCOUNT_MSK 0x80U
+
+#define IIS3DWB_WAKE_UP_SRC_Z_WU_POS             0U
+#define IIS3DWB_WAKE_UP_SRC_Z_WU_MSK             0x01U
+#define IIS3DWB_WAKE_UP_SRC_Y_WU_POS             1U
+#define IIS3DWB_WAKE_UP_SRC_Y_WU_MSK             0x02U
+#define IIS3DWB_WAKE_UP_SRC_X_WU_POS             2U
+#define IIS3DWB_WAKE_UP_SRC_X_WU_MSK             0x04U
+#define IIS3DWB_WAKE_UP_SRC_WU_IA_POS            3U
+#define IIS3DWB_WAKE_UP_SRC_WU_IA_MSK            0x08U
+#define IIS3DWB_WAKE_UP_SRC_SLEEP_STATE_IA_POS   4U
+#define IIS3DWB_WAKE_UP_SRC_SLEEP_STATE_IA_MSK   0x10U
+#define IIS3DWB_WAKE_UP_SRC_SLEEP_CHANGE_IA_POS  6U
+#define IIS3DWB_WAKE_UP_SRC_SLEEP_CHANGE_IA_MSK  0x40U
+
+#define IIS3DWB_STATUS_REG_XLDA_POS              0U
+#define IIS3DWB_STATUS_REG_XLDA_MSK              0x01U
+#define IIS3DWB_STATUS_REG_TDA_POS               2U
+#define IIS3DWB_STATUS_REG_TDA_MSK               0x04U
+
+#define IIS3DWB_FIFO_STATUS1_DIFF_FIFO_POS       0U
+#define IIS3DWB_FIFO_STATUS1_DIFF_FIFO_MSK       0xFFU
+
+#define IIS3DWB_FIFO_STATUS2_DIFF_FIFO_POS       0U
+#define IIS3DWB_FIFO_STATUS2_DIFF_FIFO_MSK       0x03U
+#define IIS3DWB_FIFO_STATUS2_FIFO_OVR_LATCHED_POS 3U
+#define IIS3DWB_FIFO_STATUS2_FIFO_OVR_LATCHED_MSK 0x08U
+#define IIS3DWB_FIFO_STATUS2_COUNTER_BDR_IA_POS  4U
+#define IIS3DWB_FIFO_STATUS2_COUNTER_BDR_IA_MSK  0x10U
+#define IIS3DWB_FIFO_STATUS2_FIFO_FULL_IA_POS    5U
+#define IIS3DWB_FIFO_STATUS2_FIFO_FULL_IA_MSK    0x20U
+#define IIS3DWB_FIFO_STATUS2_FIFO_OVR_IA_POS     6U
+#define IIS3DWB_FIFO_STATUS2_FIFO_OVR_IA_MSK     0x40U
+#define IIS3DWB_FIFO_STATUS2_FIFO_WTM_IA_POS     7U
+#define IIS3DWB_FIFO_STATUS2_FIFO_WTM_IA_MSK     0x80U
+
+#define IIS3DWB_SLOPE_EN_LIR_POS                 0U
+#define IIS3DWB_SLOPE_EN_LIR_MSK                 0x01U
+#define IIS3DWB_SLOPE_EN_SLOPE_FDS_POS           4U
+#define IIS3DWB_SLOPE_EN_SLOPE_FDS_MSK           0x10U
+#define IIS3DWB_SLOPE_EN_SLEEP_STATUS_ON_INT_POS 5U
+#define IIS3DWB_SLOPE_EN_SLEEP_STATUS_ON_INT_MSK 0x20U
+
+#define IIS3DWB_INTERRUPTS_EN_INTERRUPTS_ENABLE_POS 7U
+#define IIS3DWB_INTERRUPTS_EN_INTERRUPTS_ENABLE_MSK 0x80U
+
+#define IIS3DWB_WAKE_UP_THS_WK_THS_POS           0U
+#define IIS3DWB_WAKE_UP_THS_WK_THS_MSK           0x3FU
+#define IIS3DWB_WAKE_UP_THS_USR_OFF_ON_WU_POS    6U
+#define IIS3DWB_WAKE_UP_THS_USR_OFF_ON_WU_MSK    0x40U
+
+#define IIS3DWB_WAKE_UP_DUR_SLEEP_DUR_POS        0U
+#define IIS3DWB_WAKE_UP_DUR_SLEEP_DUR_MSK        0x0FU
+#define IIS3DWB_WAKE_UP_DUR_WAKE_THS_W_POS       4U
+#define IIS3DWB_WAKE_UP_DUR_WAKE_THS_W_MSK       0x10U
+#define IIS3DWB_WAKE_UP_DUR_WAKE_DUR_POS         5U
+#define IIS3DWB_WAKE_UP_DUR_WAKE_DUR_MSK         0x60U
+
+#define IIS3DWB_MD1_CFG_INT1_WU_POS              5U
+#define IIS3DWB_MD1_CFG_INT1_WU_MSK              0x20U
+#define IIS3DWB_MD1_CFG_INT1_SLEEP_CHANGE_POS    7U
+#define IIS3DWB_MD1_CFG_INT1_SLEEP_CHANGE_MSK    0x80U
+
+#define IIS3DWB_MD2_CFG_INT2_TIMESTAMP_POS       0U
+#define IIS3DWB_MD2_CFG_INT2_TIMESTAMP_MSK       0x01U
+#define IIS3DWB_MD2_CFG_INT2_WU_POS              5U
+#define IIS3DWB_MD2_CFG_INT2_WU_MSK              0x20U
+#define IIS3DWB_MD2_CFG_INT2_SLEEP_CHANGE_POS    7U
+#define IIS3DWB_MD2_CFG_INT2_SLEEP_CHANGE_MSK    0x80U
+
+#define IIS3DWB_INTERNAL_FREQ_FINE_FREQ_FINE_POS 0U
+#define IIS3DWB_INTERNAL_FREQ_FINE_FREQ_FINE_MSK 0xFFU
+
+#define IIS3DWB_FIFO_DATA_OUT_TAG_TAG_PARITY_POS 0U
+#define IIS3DWB_FIFO_DATA_OUT_TAG_TAG_PARITY_MSK 0x01U
+#define IIS3DWB_FIFO_DATA_OUT_TAG_TAG_CNT_POS    1U
+#define IIS3DWB_FIFO_DATA_OUT_TAG_TAG_CNT_MSK    0x06U
+#define IIS3DWB_FIFO_DATA_OUT_TAG_TAG_SENSOR_POS 3U
+#define IIS3DWB_FIFO_DATA_OUT_TAG_TAG_SENSOR_MSK 0xF8U
 /**
   * @}
   *
@@ -763,6 +986,8 @@ int32_t iis3dwb_read_reg(const stmdev_ctx_t *ctx, uint8_t reg,
 int32_t iis3dwb_write_reg(const stmdev_ctx_t *ctx, uint8_t reg,
                           uint8_t *data,
                           uint16_t len);
+int32_t iis3dwb_reg_bits_set(const stmdev_ctx_t *ctx, uint8_t reg,
+                             uint8_t mask, uint8_t val);
 
 float_t iis3dwb_from_fs2g_to_mg(int16_t lsb);
 float_t iis3dwb_from_fs4g_to_mg(int16_t lsb);
@@ -880,6 +1105,7 @@ int32_t iis3dwb_acceleration_raw_get(const stmdev_ctx_t *ctx, int16_t *val);
 
 int32_t iis3dwb_odr_cal_reg_set(const stmdev_ctx_t *ctx, uint8_t val);
 int32_t iis3dwb_odr_cal_reg_get(const stmdev_ctx_t *ctx, uint8_t *val);
+int32_t iis3dwb_xl_odr_actual_get(const stmdev_ctx_t *ctx, float_t *val);
 
 typedef enum
 {
@@ -1158,6 +1384,354 @@ typedef enum
 } iis3dwb_fifo_tag_t;
 int32_t iis3dwb_fifo_sensor_tag_get(const stmdev_ctx_t *ctx,
                                     iis3dwb_fifo_tag_t *val);
+uint16_t iis3dwb_fifo_xl_decode(const iis3dwb_fifo_out_raw_t *fdata,
+                                uint16_t num, int16_t *xl);
+
+typedef struct
+{
+  iis3dwb_odr_xl_t                odr_xl;
+  iis3dwb_fs_xl_t                 fs_xl;
+  iis3dwb_filt_xl_en_t            filt_xl;
+  iis3dwb_xl_axis_sel_t           axis_sel;
+  iis3dwb_rounding_t              rounding;
+  iis3dwb_dataready_pulsed_t      drdy_pulsed;
+  iis3dwb_pp_od_t                 pp_od;
+  iis3dwb_h_lactive_t             h_lactive;
+  iis3dwb_lir_t                   lir;
+  iis3dwb_sdo_pu_en_t             sdo_pu_en;
+  iis3dwb_sim_t                   sim;
+  iis3dwb_i2c_disable_t           i2c_disable;
+  iis3dwb_bdr_xl_t                fifo_xl_batch;
+  iis3dwb_odr_t_batch_t           fifo_temp_batch;
+  iis3dwb_fifo_timestamp_batch_t  fifo_ts_batch;
+  iis3dwb_fifo_mode_t             fifo_mode;
+  iis3dwb_pin_int_route_t         int1_route;
+  iis3dwb_pin_int_route_t         int2_route;
+  iis3dwb_slope_fds_t             hp_path_internal;
+  iis3dwb_wake_ths_w_t            wkup_ths_w;
+  iis3dwb_usr_off_w_t             usr_off_w;
+  uint16_t                        fifo_wtm;         /* 0 .. 511 */
+  uint16_t                        cnt_bdr_th;       /* 0 .. 2047 */
+  uint8_t                         bdu;
+  uint8_t                         timestamp_en;
+  uint8_t                         fast_settling;
+  uint8_t                         drdy_mask;
+  uint8_t                         all_on_int1;
+  uint8_t                         fifo_stop_on_wtm;
+  uint8_t                         wkup_ths;         /* 0 .. 63 */
+  uint8_t                         wkup_dur;         /* 0 .. 3 */
+  uint8_t                         sleep_dur;        /* 0 .. 15 */
+  uint8_t                         usr_off_on_wkup;
+  uint8_t                         usr_off_on_out;
+  int8_t                          usr_offset[3];    /* -127 .. 127 */
+} iis3dwb_cfg_t;
+
+typedef struct
+{
+  uint8_t ctrl[24];     /* PIN_CTRL (02h) .. CTRL10_C (19h) */
+  uint8_t md[10];       /* SLOPE_EN (56h) .. MD2_CFG (5Fh) */
+  uint8_t ofs_usr[3];   /* X_OFS_USR (73h) .. Z_OFS_USR (75h) */
+} iis3dwb_cfg_img_t;
+int32_t iis3dwb_cfg_img_build(const iis3dwb_cfg_t *cfg,
+                              iis3dwb_cfg_img_t *img);
+int32_t iis3dwb_cfg_img_write(const stmdev_ctx_t *ctx,
+                              const iis3dwb_cfg_img_t *img);
+int32_t iis3dwb_cfg_set(const stmdev_ctx_t *ctx, const iis3dwb_cfg_t *val);
+int32_t iis3dwb_cfg_img_get(const stmdev_ctx_t *ctx, iis3dwb_cfg_img_t *img);
+int32_t iis3dwb_cfg_img_decode(const iis3dwb_cfg_img_t *img,
+                               iis3dwb_cfg_t *cfg);
+int32_t iis3dwb_cfg_get(const stmdev_ctx_t *ctx, iis3dwb_cfg_t *val);
+
+/* iis3dwb_cfg_diff groups:
+ *  XL_FILT: filt_xl, fast_settling, hp_path_internal
+ *  DATA: bdu, rounding, drdy_pulsed, drdy_mask, timestamp_en
+ *  PIN: pp_od, h_lactive, lir, sdo_pu_en, sim, i2c_disable, all_on_int1
+ *  FIFO: batching, fifo_mode, fifo_wtm, fifo_stop_on_wtm
+ *  WKUP: wkup_ths_w, wkup_ths, wkup_dur, sleep_dur, usr_off_on_wkup
+ *  USR_OFFSET: usr_off_w, usr_off_on_out, usr_offset
+ */
+#define IIS3DWB_CFG_DIFF_XL_ODR              0x0001U
+#define IIS3DWB_CFG_DIFF_XL_FS               0x0002U
+#define IIS3DWB_CFG_DIFF_XL_FILT             0x0004U
+#define IIS3DWB_CFG_DIFF_XL_AXIS             0x0008U
+#define IIS3DWB_CFG_DIFF_DATA                0x0010U
+#define IIS3DWB_CFG_DIFF_PIN                 0x0020U
+#define IIS3DWB_CFG_DIFF_FIFO                0x0040U
+#define IIS3DWB_CFG_DIFF_BDR_CNT             0x0080U
+#define IIS3DWB_CFG_DIFF_INT1_ROUTE          0x0100U
+#define IIS3DWB_CFG_DIFF_INT2_ROUTE          0x0200U
+#define IIS3DWB_CFG_DIFF_WKUP                0x0400U
+#define IIS3DWB_CFG_DIFF_USR_OFFSET          0x0800U
+uint32_t iis3dwb_cfg_diff(const iis3dwb_cfg_t *cfg, const iis3dwb_cfg_t *ref);
+int32_t iis3dwb_cfg_verify(const stmdev_ctx_t *ctx, const iis3dwb_cfg_t *ref,
+                           uint32_t *diff);
+
+int32_t iis3dwb_ucf_load(const stmdev_ctx_t *ctx, const ucf_line_t *ucf,
+                         uint16_t len, uint16_t *mismatch);
+
+#ifndef IIS3DWB_INIT_TIMEOUT_MS
+#define IIS3DWB_INIT_TIMEOUT_MS              20U
+#endif /* IIS3DWB_INIT_TIMEOUT_MS */
+
+int32_t iis3dwb_init(const stmdev_ctx_t *ctx, const iis3dwb_cfg_img_t *img,
+                     uint32_t *ttfs);
+int32_t iis3dwb_init_multi(const stmdev_ctx_t *const ctx[], uint8_t num,
+                           const iis3dwb_cfg_img_t *img, uint32_t *ttfs,
+                           int32_t *status);
+
+#ifndef IIS3DWB_ST_MIN_MG
+#define IIS3DWB_ST_MIN_MG                    50.0f
+#endif /* IIS3DWB_ST_MIN_MG */
+#ifndef IIS3DWB_ST_MAX_MG
+#define IIS3DWB_ST_MAX_MG                    1700.0f
+#endif /* IIS3DWB_ST_MAX_MG */
+#ifndef IIS3DWB_ST_SETTLE_MS
+#define IIS3DWB_ST_SETTLE_MS                 20U
+#endif /* IIS3DWB_ST_SETTLE_MS */
+#ifndef IIS3DWB_ST_DISCARD
+#define IIS3DWB_ST_DISCARD                   64U
+#endif /* IIS3DWB_ST_DISCARD */
+#ifndef IIS3DWB_ST_SAMPLES
+#define IIS3DWB_ST_SAMPLES                   256U
+#endif /* IIS3DWB_ST_SAMPLES */
+
+typedef struct
+{
+  float_t mean_mg[3];   /* self-test disabled */
+  float_t pos_mg[3];    /* positive self-test - disabled */
+  float_t neg_mg[3];    /* disabled - negative self-test */
+  uint8_t axis_pass;    /* bit 0: X, bit 1: Y, bit 2: Z inside limits */
+  uint8_t pass;
+} iis3dwb_xl_st_result_t;
+int32_t iis3dwb_xl_self_test_run(const stmdev_ctx_t *ctx,
+                                 iis3dwb_xl_st_result_t *val);
+
+#ifndef IIS3DWB_OFS_CAL_SETTLE_MS
+#define IIS3DWB_OFS_CAL_SETTLE_MS            20U
+#endif /* IIS3DWB_OFS_CAL_SETTLE_MS */
+#ifndef IIS3DWB_OFS_CAL_DISCARD
+#define IIS3DWB_OFS_CAL_DISCARD              64U
+#endif /* IIS3DWB_OFS_CAL_DISCARD */
+#ifndef IIS3DWB_OFS_CAL_SAMPLES
+#define IIS3DWB_OFS_CAL_SAMPLES              448U
+#endif /* IIS3DWB_OFS_CAL_SAMPLES */
+
+typedef struct
+{
+  float_t bias_mg[3];       /* measured bias before the correction */
+  float_t residual_mg[3];   /* bias left with the correction applied */
+  int8_t offset[3];         /* X/Y/Z_OFS_USR programmed values */
+  iis3dwb_usr_off_w_t weight;
+} iis3dwb_xl_offset_cal_t;
+int32_t iis3dwb_xl_offset_calibrate(const stmdev_ctx_t *ctx,
+                                    const float_t *ref_mg,
+                                    iis3dwb_xl_offset_cal_t *val);
+
+typedef struct
+{
+  const int16_t *seg[2];    /* window samples (X, Y, Z), oldest first */
+  uint16_t seg_len[2];      /* samples in each segment */
+  uint16_t pre;             /* samples before the trigger */
+  uint16_t post;            /* samples from the trigger on */
+  iis3dwb_wake_up_src_t wake_up_src;  /* x_wu, y_wu, z_wu of the trigger */
+} iis3dwb_capture_evt_t;
+
+typedef void (*iis3dwb_capture_cb_t)(void *arg,
+                                     const iis3dwb_capture_evt_t *evt);
+
+typedef struct
+{
+  int16_t *ring;            /* (pre + post) * 3 samples, caller memory */
+  uint16_t pre;
+  uint16_t post;
+  iis3dwb_capture_cb_t event;
+  void *arg;
+  uint16_t head;
+  uint16_t fill;
+  uint16_t remaining;
+  uint16_t trig_pre;
+  iis3dwb_wake_up_src_t wake_up_src;
+} iis3dwb_capture_t;
+int32_t iis3dwb_capture_init(iis3dwb_capture_t *cap, int16_t *ring,
+                             uint16_t pre, uint16_t post,
+                             iis3dwb_capture_cb_t event, void *arg);
+void iis3dwb_capture_feed(iis3dwb_capture_t *cap, const int16_t *xl,
+                          uint16_t num, const iis3dwb_wake_up_src_t *trig);
+int32_t iis3dwb_capture_run(const stmdev_ctx_t *ctx, iis3dwb_capture_t *cap);
+
+typedef struct
+{
+  iis3dwb_fifo_mode_t mode;
+  uint8_t triggered;
+  iis3dwb_wake_up_src_t wake_up_src;  /* source of the last trigger */
+  iis3dwb_lir_t lir;                  /* notification before arming */
+} iis3dwb_trig_acq_t;
+int32_t iis3dwb_trig_acq_arm(const stmdev_ctx_t *ctx, iis3dwb_trig_acq_t *acq,
+                             iis3dwb_fifo_mode_t mode);
+int32_t iis3dwb_trig_acq_disarm(const stmdev_ctx_t *ctx,
+                                const iis3dwb_trig_acq_t *acq);
+int32_t iis3dwb_trig_acq_collect(const stmdev_ctx_t *ctx,
+                                 iis3dwb_trig_acq_t *acq,
+                                 iis3dwb_fifo_out_raw_t *fdata, uint16_t max,
+                                 uint16_t *num);
+
+typedef struct
+{
+  uint8_t idle;             /* 1 -> inactivity, the FIFO is not drained */
+  uint8_t resumed;          /* 1 -> activity detected on the last call */
+  int16_t summary[3];       /* last output sample, refreshed while idle */
+} iis3dwb_gate_t;
+int32_t iis3dwb_gate_init(const stmdev_ctx_t *ctx, iis3dwb_gate_t *gate,
+                          uint8_t int_pin, uint8_t dur);
+int32_t iis3dwb_gate_run(const stmdev_ctx_t *ctx, iis3dwb_gate_t *gate,
+                         uint8_t sleep, iis3dwb_fifo_out_raw_t *fdata,
+                         uint16_t max, uint16_t *num);
+
+typedef struct
+{
+  float_t t0;               /* reference temperature (degC) */
+  float_t off_tc[3];        /* offset drift (mg/degC) */
+  float_t sens_tc[3];       /* relative sensitivity drift (1/degC) */
+  float_t sens;             /* mg/LSB at t0 */
+  float_t temp;             /* last temperature read in FIFO (degC) */
+  float_t gain[3];          /* mg/LSB at temp */
+  float_t offset[3];        /* mg at temp */
+} iis3dwb_temp_comp_t;
+int32_t iis3dwb_temp_comp_init(iis3dwb_temp_comp_t *tc, iis3dwb_fs_xl_t fs,
+                               float_t t0, const float_t *off_tc,
+                               const float_t *sens_tc);
+uint16_t iis3dwb_fifo_xl_comp_to_mg(iis3dwb_temp_comp_t *tc,
+                                    const iis3dwb_fifo_out_raw_t *fdata,
+                                    uint16_t num, float_t *mg);
+
+typedef struct
+{
+  iis3dwb_xl_axis_sel_t axis_sel;   /* axis selection of the batched data */
+  uint32_t period_ns;       /* accelerometer sample period */
+  uint64_t ts_ns;           /* time of the next sample (ns) */
+  uint32_t ts_raw;          /* last timestamp word */
+  uint32_t ts_wraps;        /* timestamp counter wraps */
+  uint8_t ts_valid;
+} iis3dwb_fifo_dec_t;
+int32_t iis3dwb_fifo_dec_init(iis3dwb_fifo_dec_t *dec,
+                              iis3dwb_xl_axis_sel_t axis_sel);
+uint8_t iis3dwb_fifo_dec_stride(const iis3dwb_fifo_dec_t *dec);
+uint16_t iis3dwb_fifo_dec_run(iis3dwb_fifo_dec_t *dec,
+                              const iis3dwb_fifo_out_raw_t *fdata,
+                              uint16_t num, int16_t *xl, uint64_t *ts_ns);
+void iis3dwb_xl_block_to_mg(iis3dwb_fs_xl_t fs, const int16_t *lsb,
+                            uint32_t num, float_t *mg);
+
+#define IIS3DWB_LAT_HIST_BUCKETS             33U
+
+typedef struct
+{
+  uint32_t bucket[IIS3DWB_LAT_HIST_BUCKETS];  /* k > 0: [2^(k-1), 2^k) ticks */
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+} iis3dwb_lat_hist_t;
+void iis3dwb_lat_hist_reset(iis3dwb_lat_hist_t *hist);
+void iis3dwb_lat_hist_add(iis3dwb_lat_hist_t *hist, uint32_t ticks);
+uint32_t iis3dwb_lat_hist_percentile(const iis3dwb_lat_hist_t *hist,
+                                     uint8_t pct);
+
+typedef uint32_t (*iis3dwb_tick_ptr)(void);
+/* latency: interrupt to callback ticks (drdy), poll interval (poll) */
+typedef void (*iis3dwb_sample_cb_t)(void *arg, const int16_t *xl,
+                                    uint32_t latency);
+
+typedef struct
+{
+  iis3dwb_tick_ptr tick;            /* free running timer of the host */
+  iis3dwb_sample_cb_t sample;
+  void *arg;
+  iis3dwb_lat_hist_t hist;          /* poll interval of each sample */
+} iis3dwb_poll_t;
+int32_t iis3dwb_poll_init(iis3dwb_poll_t *poll, iis3dwb_tick_ptr tick,
+                          iis3dwb_sample_cb_t sample, void *arg);
+int32_t iis3dwb_poll_run(const stmdev_ctx_t *ctx, iis3dwb_poll_t *poll,
+                         uint32_t num);
+
+typedef struct
+{
+  iis3dwb_tick_ptr tick;            /* free running timer of the host */
+  iis3dwb_sample_cb_t sample;
+  void *arg;
+  iis3dwb_lat_hist_t hist;          /* interrupt to callback latency */
+} iis3dwb_drdy_t;
+int32_t iis3dwb_drdy_start(const stmdev_ctx_t *ctx, iis3dwb_drdy_t *drdy,
+                           iis3dwb_tick_ptr tick, iis3dwb_sample_cb_t sample,
+                           void *arg);
+int32_t iis3dwb_drdy_irq(const stmdev_ctx_t *ctx, iis3dwb_drdy_t *drdy,
+                         uint32_t irq_tick);
+
+/* int16_t elements of a frame buffer holding n FIFO words */
+#define IIS3DWB_FRAME_BUF_LEN(n)             ((((uint32_t)(n) * 7U) + 1U) / 2U)
+
+typedef void (*iis3dwb_frame_cb_t)(void *arg, int16_t *xl, uint16_t len);
+
+typedef struct
+{
+  int16_t *const *frames;   /* IIS3DWB_FRAME_BUF_LEN(len) elements each */
+  uint8_t num;              /* number of frames */
+  uint8_t next;
+  uint16_t len;             /* samples per frame */
+  iis3dwb_frame_cb_t frame;
+  void *arg;
+} iis3dwb_framer_t;
+int32_t iis3dwb_framer_start(const stmdev_ctx_t *ctx, iis3dwb_framer_t *fr,
+                             int16_t *const *frames, uint8_t num,
+                             uint16_t len, iis3dwb_frame_cb_t frame,
+                             void *arg);
+int32_t iis3dwb_framer_irq(const stmdev_ctx_t *ctx, iis3dwb_framer_t *fr);
+
+/* Memory barrier between the slot accesses and the head update of the
+ * ring. It is needed with a single core too (producer in an interrupt,
+ * consumers in other processes): only head is volatile, so without it
+ * the compiler may move slot accesses across the head update.
+ * Other compilers get an empty default: define it before including this
+ * file with the platform barrier (e.g. __DMB() with CMSIS) when the ring
+ * is used.
+ */
+#ifndef IIS3DWB_RING_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define IIS3DWB_RING_BARRIER()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define IIS3DWB_RING_BARRIER()
+#endif
+#endif /* IIS3DWB_RING_BARRIER */
+
+typedef struct
+{
+  volatile uint32_t head;   /* blocks published since the initialization */
+  uint16_t blocks;          /* ring length in blocks */
+  uint16_t block_len;       /* max samples per block */
+} iis3dwb_ring_t;
+
+/* int16_t elements of a ring slot: sample count, padding, FIFO words */
+#define IIS3DWB_RING_SLOT_LEN(len)           ((IIS3DWB_FRAME_BUF_LEN(len) + 3U) & ~1U)
+/* bytes of a ring of blocks slots holding up to len samples each */
+#define IIS3DWB_RING_SIZE(blocks, len)       (sizeof(iis3dwb_ring_t) + \
+                                              ((uint32_t)(blocks) * \
+                                               IIS3DWB_RING_SLOT_LEN(len) * \
+                                               sizeof(int16_t)))
+
+typedef struct
+{
+  uint32_t tail;            /* next block to read */
+  uint32_t lost;            /* blocks overwritten before being read */
+} iis3dwb_ring_cursor_t;
+int32_t iis3dwb_ring_init(iis3dwb_ring_t *ring, uint16_t blocks,
+                          uint16_t block_len);
+int32_t iis3dwb_ring_fifo_publish(const stmdev_ctx_t *ctx,
+                                  iis3dwb_ring_t *ring, uint16_t *num);
+void iis3dwb_ring_cursor_init(const iis3dwb_ring_t *ring,
+                              iis3dwb_ring_cursor_t *cur);
+const int16_t *iis3dwb_ring_peek(const iis3dwb_ring_t *ring,
+                                 iis3dwb_ring_cursor_t *cur, uint16_t *num);
+int32_t iis3dwb_ring_advance(const iis3dwb_ring_t *ring,
+                             iis3dwb_ring_cursor_t *cur);
 
 /**
   *@}